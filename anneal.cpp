@@ -0,0 +1,151 @@
+ /************************************************************************
+   File: anneal.cpp
+   Authors: Katie MacMillan, Jake Davidson
+   Description: This file contains the simulated annealing engine. Every
+   move is a legal swap of two free squares within a subgrid, drawn the
+   same way mutation draws one. The puzzle's fitness is updated
+   incrementally by the swap, so the change in fitness of a move costs
+   two row and two column tally updates, and a rejected move is undone by
+   swapping back.
+ ************************************************************************/
+#include "anneal.h"
+#include "population.h"
+#include "breed.h"
+
+static double startTemperature(const ProblemContext&, Puzzle&, Rng&, long long&);
+
+/******************************************************************************
+ * solveAnneal(const ProblemContext&, Puzzle&, Rng&, long long, long long&)
+ *
+ * This function searches for a solution by simulated annealing. The search
+ * starts from a random puzzle built the same way as a member of the initial
+ * population. At each step a random legal swap is made, and it is kept if it
+ * does not raise the fitness, or otherwise with probability e^(-delta / t)
+ * for the current temperature t.
+ *
+ * Swaps are made in chains, one chain being as long as the number of pairs
+ * of free squares sharing a subgrid, and the temperature is multiplied by
+ * ANNEAL_COOLING after each chain. If ANNEAL_REHEAT chains pass without the
+ * puzzle reaching a lower fitness than it has since the last restart, the
+ * search has frozen in a local minimum. The search then restarts from a new
+ * random puzzle at the starting temperature. Reheating alone is not enough,
+ * because legal swaps can not reach every legal arrangement of a subgrid (a
+ * rotation of three values may be legal when no swap of two is), so a
+ * restart draws a new arrangement to search from.
+ *
+ * params:
+ *		problem - the puzzle being solved
+ *			puz - receives the best puzzle found
+ *			rng - the random number stream to draw from
+ *	  max_moves - the most swaps to try before giving up
+ *		  moves - receives the number of swaps tried
+ *
+ * returns: true if the puzzle was solved
+ *****************************************************************************/
+bool solveAnneal(const ProblemContext &problem, Puzzle &puz, Rng &rng, long long max_moves, long long &moves)
+{
+	Puzzle current;
+	randomPuzzle(problem, current, rng);
+	current.evaluateFitness();
+	moves = 0;
+
+	double start_temp = startTemperature(problem, current, rng, moves);
+	double temp = start_temp;
+
+	// one chain tries roughly every swap in the puzzle once
+	int chain = 0;
+	for (int g = 0; g < BOARD_DIM; g++)
+	{
+		chain += problem.free_cells[g].pair_count;
+	}
+	chain = max(chain, 1);
+
+	puz = current;
+	int cycle_best = current.fitness;
+	int stale = 0;
+	while (moves < max_moves && puz.fitness > 0)
+	{
+		for (int i = 0; i < chain && moves < max_moves; i++)
+		{
+			int a, b;
+			if (!randomSwap(problem, current, rng, a, b))
+			{
+				return false;
+			}
+
+			int before = current.fitness;
+			current.swapSquares(a, b);
+			moves++;
+
+			int delta = current.fitness - before;
+			if (delta > 0 && rng.uniform() >= exp(-delta / temp))
+			{
+				current.swapSquares(a, b);
+			}
+			else if (current.fitness < puz.fitness)
+			{
+				puz = current;
+				if (puz.fitness == 0)
+					break;
+			}
+		}
+
+		temp *= ANNEAL_COOLING;
+		if (current.fitness < cycle_best)
+		{
+			cycle_best = current.fitness;
+			stale = 0;
+		}
+		else if (++stale == ANNEAL_REHEAT)
+		{
+			// frozen, so start again from a fresh arrangement
+			randomPuzzle(problem, current, rng);
+			current.evaluateFitness();
+			temp = start_temp;
+			cycle_best = current.fitness;
+			stale = 0;
+		}
+	}
+	return puz.fitness == 0;
+}
+
+/******************************************************************************
+ * startTemperature(const ProblemContext&, Puzzle&, Rng&, long long&)
+ *
+ * This function finds the starting temperature as the standard deviation of
+ * the fitness over a short random walk of ANNEAL_SAMPLES swaps. A
+ * temperature on the scale of a typical change in fitness means that early
+ * on most bad moves are accepted, and the walk also moves the puzzle away
+ * from its starting point.
+ *
+ * params:
+ *		problem - the puzzle being solved
+ *			puz - the puzzle to walk, changed in place
+ *			rng - the random number stream to draw from
+ *		  moves - incremented by the number of swaps made
+ *
+ * returns: the starting temperature, never zero
+ *****************************************************************************/
+static double startTemperature(const ProblemContext &problem, Puzzle &puz, Rng &rng, long long &moves)
+{
+	double sum = 0;
+	double sum_sq = 0;
+	int samples = 0;
+	for (int i = 0; i < ANNEAL_SAMPLES; i++)
+	{
+		int a, b;
+		if (!randomSwap(problem, puz, rng, a, b))
+			break;
+		puz.swapSquares(a, b);
+		moves++;
+		samples++;
+		sum += puz.fitness;
+		sum_sq += (double)puz.fitness * puz.fitness;
+	}
+	if (samples == 0)
+		return 1.0;
+
+	double mean = sum / samples;
+	double variance = (sum_sq / samples) - (mean * mean);
+	return max(sqrt(max(variance, 0.0)), 0.5);
+}
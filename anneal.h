@@ -0,0 +1,25 @@
+ /************************************************************************
+   File: anneal.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Function prototypes for the simulated annealing engine.
+   Annealing searches the same space as the genetic algorithm, puzzles
+   whose subgrids are permutations of every value, with the same legal
+   swap that mutation makes. It follows a single puzzle instead of a
+   population, so it only ever holds two puzzles in memory: the current
+   one and the best found.
+ ************************************************************************/
+#ifndef ANNEAL_H_
+#define ANNEAL_H_
+
+#include "globals.h"
+
+// swaps sampled to set the starting temperature
+const int ANNEAL_SAMPLES = 200;
+// temperature kept after each chain of swaps
+const double ANNEAL_COOLING = 0.9;
+// chains without a new low fitness before the search restarts
+const int ANNEAL_REHEAT = 20;
+
+bool solveAnneal(const ProblemContext&, Puzzle&, Rng&, long long, long long&);
+
+#endif
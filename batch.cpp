@@ -0,0 +1,345 @@
+ /************************************************************************
+   File: batch.cpp
+   Authors: Katie MacMillan, Jake Davidson
+   Description: This file contains batch mode. Every puzzle is read in
+   before the workers start, into a task holding the puzzle and a place
+   for its result. Each worker owns a Solver, which holds all of the
+   state of a solve and is reused for every puzzle the worker takes, so
+   workers never share solver state, only the queues they take tasks
+   from.
+
+   Each worker starts with an even, contiguous share of the tasks in a
+   queue of its own. It takes tasks from the front of its queue, and once
+   that is empty it steals from the back of the other workers' queues, so
+   a worker only ever contends with a thief when the thief has nothing
+   else to do.
+ ************************************************************************/
+#include "batch.h"
+#include "solver.h"
+#include <deque>
+#include <mutex>
+#include <dirent.h>
+#include <sys/stat.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/******************************************************************************
+ * BatchTask
+ * One puzzle of a batch and what solving it found. A task is only ever
+ * solved by the worker that took it.
+ *****************************************************************************/
+struct BatchTask
+{
+	string name; //file the puzzle came from, numbered if the file holds several
+	Puzzle puzzle; //the puzzle to solve
+	string error; //why the puzzle could not be read, empty if it was
+	SolveResult result; //what solving the puzzle found
+};
+
+/******************************************************************************
+ * WorkQueue
+ * The tasks still waiting in one worker's share of the batch.
+ *****************************************************************************/
+struct WorkQueue
+{
+	deque<int> tasks; //indices of the waiting tasks
+	mutex lock; //guards tasks, taken by the owner and by thieves
+};
+
+static bool listPuzzleFiles(const string&, vector<string>&);
+static void readTasks(const string&, deque<BatchTask>&);
+static bool takeTask(vector<WorkQueue>&, int, int&);
+static void printTask(const BatchTask&, int);
+
+// keeps result lines from different workers apart
+static mutex output_lock;
+
+/******************************************************************************
+ * runBatch(const string&, const Params&)
+ *
+ * This function solves every puzzle in a file, or in every .txt file of a
+ * directory, on a pool of worker threads. A line is printed for each puzzle
+ * as soon as it is solved, and totals for the whole batch at the end.
+ *
+ * Each puzzle is solved with the engine and parameters of a single puzzle
+ * run, but quietly. Every puzzle draws its random numbers from its own
+ * stream of the seed, chosen by its position in the batch, so a
+ * puzzle's result does not depend on which worker solved it or when. The
+ * workers already keep every core busy, so each one breeds its puzzle's
+ * population on a single thread.
+ *
+ * params:
+ *		  path - a puzzle file, or a directory of puzzle files
+ *		params - the params every puzzle is solved with, params.BATCH being
+ *				 the number of workers (0 for one per core)
+ *****************************************************************************/
+void runBatch(const string &path, const Params &params)
+{
+	vector<string> files;
+	if (!listPuzzleFiles(path, files))
+	{
+		cout << "Failed to open " << path << ".  Exiting program..." << endl;
+		exit(-1);
+	}
+
+	deque<BatchTask> tasks;
+	for (int f = 0; f < (int)files.size(); f++)
+	{
+		readTasks(files[f], tasks);
+	}
+	int task_ct = tasks.size();
+
+	int threads = params.BATCH;
+	if (threads <= 0)
+	{
+		threads = max(1, (int)thread::hardware_concurrency());
+	}
+	threads = max(1, min(threads, task_ct));
+
+	// deal each worker a contiguous share of the tasks
+	vector<WorkQueue> queues(threads);
+	for (int t = 0; t < task_ct; t++)
+	{
+		queues[((long long)t * threads) / task_ct].tasks.push_back(t);
+	}
+
+	cout << "********Solving " << task_ct << " Puzzles On " << threads << " Threads********" << endl;
+	auto start_time = chrono::high_resolution_clock::now();
+
+	vector<thread> workers;
+	for (int w = 0; w < threads; w++)
+	{
+		workers.push_back(thread([&, w]() {
+#ifdef _OPENMP
+			omp_set_num_threads(1);
+#endif
+			Solver solver;
+			Params task_params = params;
+			task_params.VERBOSE = false;
+
+			int t;
+			while (takeTask(queues, w, t))
+			{
+				BatchTask &task = tasks[t];
+				if (task.error.empty())
+				{
+					task_params.STREAM = t;
+					task.result = solver.solve(task.puzzle, task_params);
+					task.error = task.result.error;
+				}
+				printTask(task, params.ENGINE);
+			}
+		}));
+	}
+	for (int w = 0; w < threads; w++)
+	{
+		workers[w].join();
+	}
+	chrono::duration<double, milli> millisec = chrono::high_resolution_clock::now() - start_time;
+
+	// total up the batch
+	int solved = 0;
+	int preprocessed = 0;
+	int unreadable = 0;
+	double solve_msec = 0;
+	for (int t = 0; t < task_ct; t++)
+	{
+		const BatchTask &task = tasks[t];
+		if (!task.error.empty())
+		{
+			unreadable++;
+			continue;
+		}
+		solved += task.result.solved;
+		preprocessed += task.result.preprocessed;
+		solve_msec += task.result.msec;
+	}
+	int attempted = task_ct - unreadable;
+
+	cout << "************Batch Results************" << endl;
+	cout << left << setw(25) << "puzzles: " << task_ct << endl;
+	cout << left << setw(25) << "solved: " << solved << endl;
+	cout << left << setw(25) << "solved by preprocessing: " << preprocessed << endl;
+	cout << left << setw(25) << "unsolved: " << (attempted - solved) << endl;
+	cout << left << setw(25) << "unreadable: " << unreadable << endl;
+	cout << left << setw(25) << "worker threads: " << threads << endl;
+	cout << left << setw(25) << "wall time: " << millisec.count() << " msec" << endl;
+	cout << left << setw(25) << "mean solve time: " << (attempted > 0 ? solve_msec / attempted : 0) << " msec" << endl;
+	cout << left << setw(25) << "puzzles/sec: " << (attempted / millisec.count()) * 1000 << endl;
+}
+
+/******************************************************************************
+ * listPuzzleFiles(const string&, vector<string>&)
+ *
+ * This function finds the files of a batch. A directory gives every .txt
+ * file directly inside it, in name order, and anything else is taken to be
+ * a single puzzle file.
+ *
+ * params:
+ *		 path - a puzzle file, or a directory of puzzle files
+ *		files - receives the paths of the puzzle files
+ *
+ * returns: false if the path does not exist or the directory can not be read
+ *****************************************************************************/
+static bool listPuzzleFiles(const string &path, vector<string> &files)
+{
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+		return false;
+
+	if (!S_ISDIR(info.st_mode))
+	{
+		files.push_back(path);
+		return true;
+	}
+
+	DIR *dir = opendir(path.c_str());
+	if (dir == NULL)
+		return false;
+
+	string prefix = (path[path.length() - 1] == '/') ? path : path + "/";
+	for (dirent *entry = readdir(dir); entry != NULL; entry = readdir(dir))
+	{
+		string name(entry->d_name);
+		string file = prefix + name;
+		if (name.length() > 4 && name.compare(name.length() - 4, 4, ".txt") == 0 &&
+			stat(file.c_str(), &info) == 0 && S_ISREG(info.st_mode))
+		{
+			files.push_back(file);
+		}
+	}
+	closedir(dir);
+
+	sort(files.begin(), files.end());
+	return true;
+}
+
+/******************************************************************************
+ * readTasks(const string&, deque<BatchTask>&)
+ *
+ * This function reads every puzzle in a file, one after another, adding a
+ * task for each. A file holding more than one puzzle has its tasks numbered
+ * from 1. A puzzle that can not be read still gets a task, holding the
+ * error, and ends the file, since the puzzles after it can not be found.
+ *
+ * params:
+ *		file_name - the path of the puzzle file
+ *			tasks - receives a task for each puzzle
+ *****************************************************************************/
+static void readTasks(const string &file_name, deque<BatchTask> &tasks)
+{
+	ifstream file(file_name);
+	if (!file.is_open())
+	{
+		tasks.emplace_back();
+		tasks.back().name = file_name;
+		tasks.back().error = "Failed to open file.";
+		return;
+	}
+
+	int first = tasks.size();
+	while (true)
+	{
+		tasks.emplace_back();
+		BatchTask &task = tasks.back();
+		task.name = file_name;
+		if (readPuzzle(file, task.puzzle, task.error))
+			continue;
+
+		// reaching the end of the file is only an error if it held no puzzle at all
+		if (task.error.empty())
+		{
+			if ((int)tasks.size() - 1 > first)
+				tasks.pop_back();
+			else
+				task.error = "No puzzle found.";
+		}
+		break;
+	}
+
+	if ((int)tasks.size() - first > 1)
+	{
+		for (int t = first; t < (int)tasks.size(); t++)
+		{
+			tasks[t].name += "#" + to_string(t - first + 1);
+		}
+	}
+}
+
+/******************************************************************************
+ * takeTask(vector<WorkQueue>&, int, int&)
+ *
+ * This function gives a worker its next task. The worker's own queue is
+ * taken from the front. Once it is empty the other queues are tried in turn,
+ * starting from the next worker's, and a task is stolen from the back of the
+ * first one that still has any. Tasks are never added once the workers have
+ * started, so when every queue is empty the batch is done.
+ *
+ * params:
+ *		queues - the queue of every worker
+ *		  self - the worker's own queue
+ *			 t - receives the index of the task
+ *
+ * returns: false once there are no tasks left
+ *****************************************************************************/
+static bool takeTask(vector<WorkQueue> &queues, int self, int &t)
+{
+	{
+		WorkQueue &own = queues[self];
+		lock_guard<mutex> lock(own.lock);
+		if (!own.tasks.empty())
+		{
+			t = own.tasks.front();
+			own.tasks.pop_front();
+			return true;
+		}
+	}
+
+	for (int i = 1; i < (int)queues.size(); i++)
+	{
+		WorkQueue &victim = queues[(self + i) % queues.size()];
+		lock_guard<mutex> lock(victim.lock);
+		if (!victim.tasks.empty())
+		{
+			t = victim.tasks.back();
+			victim.tasks.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
+
+/******************************************************************************
+ * printTask(const BatchTask&, int)
+ *
+ * This function prints the result line of one puzzle: whether it was solved,
+ * the fitness of the best puzzle, how long the engine ran for and the time
+ * taken, or why the puzzle could not be read.
+ *
+ * params:
+ *		  task - the finished task
+ *		engine - the engine the puzzle was solved with
+ *****************************************************************************/
+static void printTask(const BatchTask &task, int engine)
+{
+	const char* units[] = {"generations", "nodes", "moves"};
+	const SolveResult &result = task.result;
+
+	lock_guard<mutex> lock(output_lock);
+	cout << task.name << ": ";
+	if (!task.error.empty())
+	{
+		cout << task.error << endl;
+	}
+	else if (result.preprocessed)
+	{
+		cout << "solved by preprocessing, " << result.msec << " msec" << endl;
+	}
+	else
+	{
+		cout << (result.solved ? "solved" : "unsolved") << ", fitness " << result.best.fitness;
+		cout << ", " << result.iterations << " " << units[engine];
+		cout << ", " << result.msec << " msec" << endl;
+	}
+}
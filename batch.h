@@ -0,0 +1,18 @@
+ /************************************************************************
+   File: batch.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Function prototypes for batch mode, which solves every
+   puzzle in a file or a directory of puzzle files in one process. The
+   puzzles are shared out between a pool of worker threads, and a worker
+   that runs out of puzzles steals them from the others, so a run of
+   puzzles that preprocessing finishes instantly never leaves a core
+   idle while another still has hard puzzles waiting.
+ ************************************************************************/
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include "globals.h"
+
+void runBatch(const string&, const Params&);
+
+#endif
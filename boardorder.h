@@ -0,0 +1,60 @@
+ /************************************************************************
+   File: boardorder.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Compile time board size. The board order is the dimension
+   of a subgrid, so an order 3 board is the usual 9x9 puzzle, and orders 2,
+   4 and 5 give 4x4, 16x16 and 25x25 puzzles. Every puzzle, population and
+   tally in a build is sized for that one order, which lets the compiler
+   treat the row, column and subgrid loops as fixed length and unroll them.
+
+   Usage: The order defaults to 3. Build with -DBOARD_ORDER=N (see the
+   makefile targets sudoku4, sudoku16 and sudoku25) for other sizes. Values
+   are written with the symbols 1-9 and then A-P, so a 16x16 puzzle uses
+   1-9 and A-G. Use valueIndex() and valueSymbol() to convert between a
+   symbol and its 0 based index.
+ ************************************************************************/
+#ifndef BOARDORDER_H_
+#define BOARDORDER_H_
+
+#ifndef BOARD_ORDER
+#define BOARD_ORDER 3
+#endif
+
+static_assert(BOARD_ORDER >= 2 && BOARD_ORDER <= 5, "BOARD_ORDER must be between 2 and 5");
+
+const int BOARD_SUBDIM = BOARD_ORDER; //subgrids are BOARD_SUBDIM x BOARD_SUBDIM
+const int BOARD_DIM = BOARD_SUBDIM * BOARD_SUBDIM; //puzzles are BOARD_DIM x BOARD_DIM
+const int BOARD_SQUARES = BOARD_DIM * BOARD_DIM; //number of squares in a puzzle
+
+// symbols for each value index, digits first and then letters
+constexpr char VALUE_SYMBOLS[] = "123456789ABCDEFGHIJKLMNOP";
+
+/******************************************************************
+ * valueIndex(char symbol)
+ * Convert a value symbol to its 0 based index. Boards of 9x9 or
+ * smaller only use digits, so the letter check is compiled out.
+ * Blanks ('-') and unknown symbols give an index outside [0, dim).
+ *
+ * params:
+ *			symbol - the value symbol
+ * returns: the index of the value
+ *****************************************************************/
+constexpr int valueIndex(char symbol)
+{
+	return (BOARD_DIM <= 9 || symbol <= '9') ? symbol - '1' : symbol - 'A' + 9;
+}
+
+/******************************************************************
+ * valueSymbol(int index)
+ * Convert a 0 based value index to its symbol
+ *
+ * params:
+ *			index - the index of the value, from 0 to BOARD_DIM-1
+ * returns: the symbol of the value
+ *****************************************************************/
+constexpr char valueSymbol(int index)
+{
+	return VALUE_SYMBOLS[index];
+}
+
+#endif
@@ -0,0 +1,87 @@
+ /************************************************************************
+   File: boardtables.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Lookup tables describing the layout of the board. For each
+   square they give its row, column and subgrid and the squares it shares
+   a row, column or subgrid with (its peers), and for each row, column and
+   subgrid (unit) they give the squares in it. The board order is fixed at
+   compile time, so the tables are built by the compiler and the hot loops
+   read positions out of them instead of dividing and taking modulos.
+
+   Usage: Read the tables through the BOARD constant, for example
+   BOARD.row[pos], BOARD.peers[pos][i] or BOARD.units[BOX_UNIT + g][i].
+   Units are numbered with the rows first, then the columns and then the
+   subgrids, so ROW_UNIT, COL_UNIT and BOX_UNIT are the first of each.
+   Subgrids are numbered left to right, top to bottom, and the squares of
+   every unit are listed in row major order.
+ ************************************************************************/
+#ifndef BOARDTABLES_H_
+#define BOARDTABLES_H_
+
+#include "boardorder.h"
+
+// peers (squares sharing a row, column or subgrid) of every square, 20 for 9x9
+const int BOARD_PEERS = (3 * BOARD_DIM) - (2 * BOARD_SUBDIM) - 1;
+// rows, columns and subgrids
+const int BOARD_UNITS = 3 * BOARD_DIM;
+// first unit of each kind
+const int ROW_UNIT = 0;
+const int COL_UNIT = BOARD_DIM;
+const int BOX_UNIT = 2 * BOARD_DIM;
+
+/******************************************************************************
+ * BoardTables
+ * The lookup tables for one board order. Only ever built by makeBoardTables.
+ *****************************************************************************/
+struct BoardTables
+{
+	int row[BOARD_SQUARES]; //row of each square
+	int col[BOARD_SQUARES]; //column of each square
+	int box[BOARD_SQUARES]; //subgrid of each square
+	int units[BOARD_UNITS][BOARD_DIM]; //squares in each row, column and subgrid
+	int peers[BOARD_SQUARES][BOARD_PEERS]; //peers of each square, in row major order
+};
+
+/******************************************************************
+ * makeBoardTables()
+ * Work out the board tables. This is only called to initialise the
+ * BOARD constant below, so it runs at compile time.
+ *
+ * returns: the filled in tables
+ *****************************************************************/
+constexpr BoardTables makeBoardTables()
+{
+	BoardTables t = {};
+	int filled[BOARD_UNITS] = {};
+
+	for (int pos = 0; pos < BOARD_SQUARES; pos++)
+	{
+		int r = pos / BOARD_DIM;
+		int c = pos % BOARD_DIM;
+		int g = ((r / BOARD_SUBDIM) * BOARD_SUBDIM) + (c / BOARD_SUBDIM);
+		t.row[pos] = r;
+		t.col[pos] = c;
+		t.box[pos] = g;
+		t.units[ROW_UNIT + r][filled[ROW_UNIT + r]++] = pos;
+		t.units[COL_UNIT + c][filled[COL_UNIT + c]++] = pos;
+		t.units[BOX_UNIT + g][filled[BOX_UNIT + g]++] = pos;
+	}
+
+	// a peer is any other square in one of the square's three units
+	for (int pos = 0; pos < BOARD_SQUARES; pos++)
+	{
+		int n = 0;
+		for (int other = 0; other < BOARD_SQUARES; other++)
+		{
+			if (other != pos && (t.row[other] == t.row[pos] || t.col[other] == t.col[pos] || t.box[other] == t.box[pos]))
+			{
+				t.peers[pos][n++] = other;
+			}
+		}
+	}
+	return t;
+}
+
+constexpr BoardTables BOARD = makeBoardTables();
+
+#endif
@@ -2,73 +2,109 @@
    File: breed.cpp
    Authors: Katie MacMillian, Jake Davidson
    Description: This file contains functions involved with breeding members
-   of the population. This file assumes it has global access to the population 
-   and breeding pool.
+   of the population. Each function works on the island it is given, so
+   several islands can be bred at once.
  ************************************************************************/
 #include "breed.h"
 
+static int legalSwaps(Puzzle&, const FreeCells&, bool, int*);
+
 /******************************************************************************
- * breed()
+ * breed(Island&)
  *
  * This function selects the designated number of breeders from the parent
- * population and uses them to breed a child generation. This breeder pool is
- * then randomized.
+ * population and uses them to breed a child generation. The breeder pool
+ * holds the population indices of the breeders rather than copies of them,
+ * and these indices are then randomized.
  *
  * If the elitism flag is not set, or the breeder pool is larger than half the
  * population size, then the iteration limit for the breeder pool is set to
- * half the population size.
+ * half the population size. If the limit runs past the end of the breeder
+ * pool, the pool is wrapped around.
  *
  * The function then iterates through the breeder population, breeding pairs
  * until either all have been bred, or until the population in generation is
- * full.
+ * full. Each pair owns two fixed slots in the new generation. The parents are
+ * copied straight into those slots and crossed over in place, so each child
+ * costs a single puzzle copy.
+ *
+ * Pairs are bred in parallel. Each pair draws its random numbers from its own
+ * stream, derived from a per generation seed and the pair's index, so no
+ * generator is shared between threads and a given master seed always breeds
+ * the same children no matter how the pairs are split between threads.
+ * When local search is turned on, both children are improved in their slots
+ * by the same thread that bred them.
  *
  * If the elitism flag is set to true, then the remaining population is
  * filled with members of the parent population.
+ *
+ * params:
+ *		isl - the island to breed
  *****************************************************************************/
-void breed()
+void breed(Island &isl)
 {
+	const Params &params = *isl.params;
+
 	// select top portion of population for breeding
-	for (int i = 0; i < const_data.BREEDERS; i++){
-		breeding_pool[i] = population[i];
+	for (int i = 0; i < params.BREEDERS; i++){
+		isl.breeding_pool[i] = isl.ranking[i];
 	}
 
 	// shuffle breeders
-	random_shuffle(breeding_pool.begin(), breeding_pool.end());
+	isl.rng.shuffle(isl.breeding_pool.begin(), isl.breeding_pool.end());
 
 	/* max iterations should not exceed half the population size and should be
 	 * half the population size if elitism flag is not set
 	 */
-	int i_max = const_data.BREEDERS;
-	if ((i_max > const_data.POP / 2) || !const_data.ELITISM_FLAG)
+	int i_max = params.BREEDERS;
+	if ((i_max > params.POP / 2) || !params.ELITISM_FLAG)
 	{
-		i_max = const_data.POP / 2;
+		i_max = params.POP / 2;
 	}
-	// index 0 is a special case, it gets bred with last breeder
-	int pos = 0;
-	createNextGeneration(breeding_pool[0], breeding_pool[i_max-1]);
-	new_generation[pos++] = breeding_pool[0];
-	new_generation[pos++] = breeding_pool[i_max-1];
+	// nobody to breed without a breeding pool
+	if (params.BREEDERS == 0)
+	{
+		i_max = 0;
+	}
+
+	// every pair derives its own random stream from this generation's seed
+	uint64_t generation_seed = isl.rng.next();
 
 	#pragma omp parallel for
-	for (int i = 1; i < i_max; i++)
+	for (int i = 0; i < i_max; i++)
 	{
-		createNextGeneration(breeding_pool[i], breeding_pool[i-1]);
-		new_generation[pos++] = breeding_pool[i];
-		new_generation[pos++] = breeding_pool[i-1];
+		Rng rng(generation_seed, i);
+
+		// index 0 is a special case, it gets bred with last breeder
+		int prev = (i == 0) ? i_max - 1 : i - 1;
+
+		// write the parents directly into this pair's slots and breed them there
+		Puzzle &curr_child = isl.new_generation[2 * i];
+		Puzzle &prev_child = isl.new_generation[(2 * i) + 1];
+		curr_child = isl.population[isl.breeding_pool[i % params.BREEDERS]];
+		prev_child = isl.population[isl.breeding_pool[prev % params.BREEDERS]];
+		createNextGeneration(*isl.problem, curr_child, prev_child, rng, isl.mutation_rate);
+		if (params.LOCAL_SEARCH > 0)
+		{
+			improve(*isl.problem, curr_child, rng, params.LOCAL_SEARCH);
+			improve(*isl.problem, prev_child, rng, params.LOCAL_SEARCH);
+		}
 	}
+	int pos = 2 * i_max;
+
 	// handle elitism
-	if (const_data.ELITISM_FLAG)
+	if (params.ELITISM_FLAG)
 	{
-		addElite(pos);
-		pos += const_data.ELITE;
-		addLucky(pos);
+		addElite(isl, pos);
+		pos += params.ELITE;
+		addLucky(isl, pos);
 	}
 	
-	swap(population, new_generation);
+	swap(isl.population, isl.new_generation);
 }
 
 /******************************************************************************
- * mutateOnly()
+ * mutateOnly(Island&)
  *
  * This function selects the designated number of breeders from the parent
  * population and uses them to breed a child generation. This breeder pool is
@@ -80,54 +116,77 @@ void breed()
  *
  * The function then iterates through the breeder population, mutating each
  * breeder until either each has been mutated twice, or until the population
- * in generation is full.
+ * in generation is full. Each breeder is copied straight into its slot in the
+ * new generation and mutated there, so the breeders themselves are never
+ * changed and every child is an independent mutation. Slots are filled in
+ * parallel, each drawing from its own random stream derived from a per
+ * generation seed and the slot's index, so the result only depends on the
+ * master seed. When local search is turned on, each mutated child is also
+ * improved in its slot.
  *
  * If the elitism flag is set to true, then the remaining population is
  * filled with members of the parent population.
+ *
+ * params:
+ *		isl - the island to mutate
  *****************************************************************************/
-void mutateOnly()
+void mutateOnly(Island &isl)
 {
+	const Params &params = *isl.params;
+
 	// select top portion of population for breeding
-	for (int i = 0; i < const_data.BREEDERS; i++){
-		breeding_pool[i] = population[i];
+	for (int i = 0; i < params.BREEDERS; i++){
+		isl.breeding_pool[i] = isl.ranking[i];
 	}
 
 	// shuffle breeders
-	random_shuffle(breeding_pool.begin(), breeding_pool.end());
+	isl.rng.shuffle(isl.breeding_pool.begin(), isl.breeding_pool.end());
 
 	/* max iterations should not exceed population size and should be population
 	 * size if elitism flag is not set
 	 */
-	int i_max = const_data.BREEDERS * 2;
-	if ((i_max > const_data.POP) || !const_data.ELITISM_FLAG)
+	int i_max = params.BREEDERS * 2;
+	if ((i_max > params.POP) || !params.ELITISM_FLAG)
 	{
-		i_max = const_data.POP;
+		i_max = params.POP;
 	}
+	// nothing to mutate without a breeding pool
+	if (params.BREEDERS == 0)
+	{
+		i_max = 0;
+	}
+
+	// every slot derives its own random stream from this generation's seed
+	uint64_t generation_seed = isl.rng.next();
 
-	int pos = 0;
-	int b = 0;
+	#pragma omp parallel for
 	for (int i = 0; i < i_max; i++)
 	{
+		Rng rng(generation_seed, i);
+
 		// wrap iterator to beginning of breeder vector
-		mutate(breeding_pool[b]);
-		new_generation[pos] = breeding_pool[b];
-		b = (b + 1) % const_data.BREEDERS;
-		pos++;
+		isl.new_generation[i] = isl.population[isl.breeding_pool[i % params.BREEDERS]];
+		mutate(*isl.problem, isl.new_generation[i], rng);
+		if (params.LOCAL_SEARCH > 0)
+		{
+			improve(*isl.problem, isl.new_generation[i], rng, params.LOCAL_SEARCH);
+		}
 	}
+	int pos = i_max;
 
 	// handle elitism
-	if (const_data.ELITISM_FLAG)
+	if (params.ELITISM_FLAG)
 	{
-		addElite(pos);
-		pos += const_data.ELITE;
-		addLucky(pos);		
+		addElite(isl, pos);
+		pos += params.ELITE;
+		addLucky(isl, pos);		
 	}
 	
-	swap(population, new_generation);
+	swap(isl.population, isl.new_generation);
 }
 
 /******************************************************************************
- * createNextGeneration(Puzzle, Puzzle, vector<Puzzle>&)
+ * createNextGeneration(const ProblemContext&, Puzzle&, Puzzle&, Rng&, int)
  *
  * This function uses two puzzles from the stock of breeders and breeds them
  * together.
@@ -137,24 +196,29 @@ void mutateOnly()
  * swapped between the curr and prev puzzles. Subgrids which have a value of
  * true will be swapped between the two puzzles.
  *
- * The function then iterates through both puzzles at the same time. For each
- * 1-D position, the corresponding subgrid position is calculated. If the
- * subgrid position value in the boolean array is true, then the corresponding
- * square is swapped in the two puzzles
+ * The function then walks the free squares of each subgrid marked for swapping,
+ * using the free square lists built from the initial puzzle. Preset squares
+ * are the same in every puzzle, so they are never visited. Each free square
+ * whose value differs between the two puzzles is swapped. Each swap updates
+ * the fitness of both puzzles incrementally, so the children never need a
+ * full re-evaluation.
  *
  * params:
+ *		 problem - the puzzle being solved
  *			curr - the puzzle in the current iteration position in the
  *				   calling function
  *			prev - the puzzle in the position previor to the current iteration
  *				   position in the calling function
+ *			 rng - the random number stream for this pair
+ *   mutation_rate - the percent chance that each child mutates
  ******************************************************************************/
-void createNextGeneration(Puzzle &curr, Puzzle &prev)
+void createNextGeneration(const ProblemContext &problem, Puzzle &curr, Puzzle &prev, Rng &rng, int mutation_rate)
 {
 	// randomly set the which subgrid positions will be swapped
-	bool cross_over[9];
-	for (int i = 0; i < 9; i++)
+	bool cross_over[BOARD_DIM];
+	for (int i = 0; i < BOARD_DIM; i++)
 	{
-		if(rand()%2 == 0)
+		if(rng.below(2) == 0)
 		{
 			cross_over[i] = true;
 		}
@@ -164,164 +228,234 @@ void createNextGeneration(Puzzle &curr, Puzzle &prev)
 		}
 	}
 	// breed the puzzles
-	for( int pos = 0; pos < const_data.DIM * const_data.DIM; pos++)
+	for (int g = 0; g < BOARD_DIM; g++)
 	{
-		// retrieve the subgrid position based on 1-D puzzle position
-		int grid = getGridPosition(pos);
-
 		// check if the subgrid is to be swapped with the previous puzzle or not
-		if (cross_over[grid])
+		if (!cross_over[g])
+			continue;
+
+		const FreeCells &cells = problem.free_cells[g];
+		for (int i = 0; i < cells.count; i++)
 		{
-			square temp = prev[pos]; 
-			prev[pos] = curr[pos];
-			curr[pos] = temp;
+			// squares which already match are left alone, so only rows and columns
+			// through differing squares have their fitness updated
+			int pos = cells.positions[i];
+			if (prev.getValue(pos) != curr.getValue(pos))
+			{
+				char temp = prev.getValue(pos);
+				prev.replaceValue(pos, curr.getValue(pos));
+				curr.replaceValue(pos, temp);
+			}
 		}
 	}
 	// roll the dice to see if either of the puzzles mutate
-	if(rand()%100 < mutation_rate)
+	if(rng.below(100) < mutation_rate)
 	{
-		mutate(prev);
+		mutate(problem, prev, rng);
 	}
-	if(rand()%100 < mutation_rate)
+	if(rng.below(100) < mutation_rate)
 	{
-		mutate(curr);
+		mutate(problem, curr, rng);
 	}
 }
 
 /******************************************************************************
- * addElite(vector<Puzzle>&)
+ * addElite(Island&, int)
  *
  * This function retrieves a pre-determined number of the most fit puzzles from
- * the parent population and carries them over into the new generation.
+ * the parent population, using the fitness ranking, and carries them over into
+ * the new generation.
  *
  * params:
+ *		isl - the island whose new generation is being filled
  *		pos - the current position in the new generation vector
 *****************************************************************************/
-void addElite(int pos)
+void addElite(Island &isl, int pos)
 {
+	const Params &params = *isl.params;
+
 	// add best of the population to the new generation
-	for (int e = 0; e < const_data.ELITE; e++)
+	for (int e = 0; e < params.ELITE; e++)
 	{
-		new_generation[pos] = population[e];
+		isl.new_generation[pos] = isl.population[isl.ranking[e]];
 		pos++;
 	}
 }
 
 /******************************************************************************
- * addLucky(vector<Puzzle>&)
+ * addLucky(Island&, int)
  *
  * This function selects a number of random puzzles from the parent population
  * which are not in the top elite population group. These "lucky" individuals
- * are carried over into the new generation.
+ * are carried over into the new generation. Should the elite group be the
+ * whole population, the lucky are drawn from all of it instead.
  *
  * params:
+ *		isl - the island whose new generation is being filled
  *		pos - the current position in the new generation vector
  *****************************************************************************/
-void addLucky(int pos)
+void addLucky(Island &isl, int pos)
 {
+	const Params &params = *isl.params;
+
+	// the chosen are never part of the elite group, unless there is nothing else
+	int size = isl.population.size();
+	int first = params.ELITE;
+	if (first >= size)
+	{
+		first = 0;
+	}
+
 	// add a few lucky souls to the new generation
-	for(int i = 0; i < const_data.LUCKY; i++)
+	for(int i = 0; i < params.LUCKY; i++)
 	{
 		// pick a random puzzle
-		int l = rand()%population.size();
-
-		// ensure the chosen are not part of the elite group
-		if (l < const_data.ELITE)
-		{
-			l += const_data.ELITE;
-		}
-		new_generation[pos] = population[l];
+		int l = first + isl.rng.below(size - first);
+		isl.new_generation[pos] = isl.population[isl.ranking[l]];
 		pos++;
 	}
 }
 
 /******************************************************************************
- * mutate(Puzzle&)
+ * mutate(const ProblemContext&, Puzzle&, Rng&)
  *
  * This function selects a random subgrid within the passed in puzzle, and then
  * selects two random, non-preset positions within the subgrid. The values in
  * these two positions are then swapped.
  *
+ * Only legal swaps are made, where each value is possible in the square it
+ * moves to, so a puzzle never holds a value preprocessing ruled out. The two
+ * positions are drawn from the subgrid's precomputed swap pairs, keeping the
+ * pairs whose current values can trade places. If the chosen subgrid has no
+ * legal swap right now another is tried, up to once per mutable subgrid.
+ *
  * params:
+ * 	problem - the puzzle being solved
  * 		puz - a reference to a puzzle object to be mutated
+ * 		rng - the random number stream to draw from
  *****************************************************************************/
-void mutate( Puzzle &puz)
+void mutate(const ProblemContext &problem, Puzzle &puz, Rng &rng)
 {
-	//limit the number of times we try and find a mutate point (in case we hit a statistical home run)
-	int search_limit = 100;
+	int a, b;
+	if (randomSwap(problem, puz, rng, a, b))
+	{
+		// swap the two values in place, updating fitness as we go
+		puz.swapSquares(a, b);
+	}
+}
 
-	// grab a random row and column and associated subgrid position
-	int r = rand() % const_data.DIM;
-	int c = rand() % const_data.DIM;
-	int g = getGridPosition((r * const_data.DIM) + c);
+/******************************************************************************
+ * randomSwap(const ProblemContext&, Puzzle&, Rng&, int&, int&)
+ *
+ * This function picks the random legal swap used by mutate(), without making
+ * it, so other searches can make the same move and undo it.
+ *
+ * params:
+ * 	problem - the puzzle being solved
+ * 		puz - the puzzle the swap would be made in
+ * 		rng - the random number stream to draw from
+ * 		  a - receives the 1D position of the first square
+ * 		  b - receives the 1D position of the second square
+ *
+ * returns: true if a legal swap was found
+ *****************************************************************************/
+bool randomSwap(const ProblemContext &problem, Puzzle &puz, Rng &rng, int &a, int &b)
+{
+	//check that there is a subgrid with at least two non-preset values
+	const vector<int> &subgrids = problem.mutable_subgrids;
+	for (int attempt = 0; attempt < (int)subgrids.size(); attempt++)
+	{
+		// grab a random subgrid that can be mutated
+		const FreeCells &cells = problem.free_cells[subgrids[rng.below(subgrids.size())]];
 
-	vector<square> grid = puz.getSub(r, c);
+		int legal[MAX_SWAP_PAIRS];
+		int legal_ct = legalSwaps(puz, cells, false, legal);
+		if (legal_ct == 0)
+			continue;
 
-	//check that there are at least two non-preset values in the grid
-	if (puz.subgrid_presets[g] > 7)
-		return;
+		const SwapPair &pair = cells.pairs[legal[rng.below(legal_ct)]];
+		a = cells.positions[pair.first];
+		b = cells.positions[pair.second];
+		return true;
+	}
+	return false;
+}
 
-	int i1;
-	int i2;
-	int iter = 0;
+/******************************************************************************
+ * improve(const ProblemContext&, Puzzle&, Rng&, int)
+ *
+ * This function is the local search stage of the memetic algorithm. Up to
+ * 'swaps' swaps are tried on the puzzle, and a swap is only
+ * kept if it strictly lowers the puzzle's fitness. Each swap is drawn from a
+ * random subgrid's legal swap pairs which include a square whose value is
+ * duplicated in its row or column, since a swap of two squares without a
+ * duplicate can never lower the fitness. Swaps update the fitness
+ * incrementally and a rejected swap is simply swapped back, so a swap costs
+ * about as much as a mutation.
+ *
+ * params:
+ * 	problem - the puzzle being solved
+ * 		puz - a reference to the puzzle to improve
+ * 		rng - the random number stream to draw from
+ * 	  swaps - the most swaps to try
+ *****************************************************************************/
+void improve(const ProblemContext &problem, Puzzle &puz, Rng &rng, int swaps)
+{
+	const vector<int> &subgrids = problem.mutable_subgrids;
+	if (subgrids.empty())
+		return;
 
-	// look for different squares where neither contain preset values
-	do
+	for (int tried = 0; tried < swaps && puz.fitness > 0; tried++)
 	{
-		// grab two random positions within the subgrid
-		i1 = rand() % const_data.DIM;
-		i2 = rand() % const_data.DIM;
-		iter++;
-	} while (((i1 == i2) || grid[i1].preset || grid[i2].preset) && iter < search_limit);
+		const FreeCells &cells = problem.free_cells[subgrids[rng.below(subgrids.size())]];
+		int legal[MAX_SWAP_PAIRS];
+		int legal_ct = legalSwaps(puz, cells, true, legal);
+		if (legal_ct == 0)
+			continue;
 
-	if(iter < search_limit)
-	{
-		// swap the two values
-		char temp = grid[i1].getValue();
-		grid[i1].setValue(grid[i2].getValue());
-		grid[i2].setValue(temp);
-		puz.setSub(r,c, grid);		
+		// keep the swap only if it removes duplicates
+		const SwapPair &pair = cells.pairs[legal[rng.below(legal_ct)]];
+		int a = cells.positions[pair.first];
+		int b = cells.positions[pair.second];
+		int before = puz.fitness;
+		puz.swapSquares(a, b);
+		if (puz.fitness >= before)
+		{
+			puz.swapSquares(a, b);
+		}
 	}
 }
 
 /******************************************************************************
- * getGridPosition(int)
- *
- * This function uses a very awful looking function to compute the subgrid 
- * position of any given square based on its 1-D position within the puzzle.
- *
- * In an attempt to make the process more clear, what could be done in a 
- * single, horrifying, statement has been broken down into several steps
- * with clear variable names.
+ * legalSwaps(Puzzle&, const FreeCells&, bool, int*)
  *
- * The row and column are calculated based on the 1-D position.
- *
- * Next the starting row and column for the subgrid where the row and column
- * intersect are computed. 
- *
- * The first subgrid the farthest to the left in each row of subgrids will
- * have a position corresponding to the first row of itself.
- *
- * In order to compute the subgrid position for any subgrid, the quotient of
- * the subgrid start column divided by the subgrid dimension is added to the
- * subgrid start row.
+ * This function finds the swap pairs of a subgrid which are legal for a
+ * puzzle, meaning each square's current value is possible in the other
+ * square.
  *
  * params:
- *			pos - a 1-D position within a puzzle
+ * 		  puz - the puzzle the swaps would be made in
+ * 		cells - the free squares and swap pairs of the subgrid
+ * 	 conflicts - if true, only pairs with a conflicting square are kept
+ * 		legal - receives the indices of the legal swap pairs
  *
- * returns: the integer subgrid position corresponding to the 1-D puzzle
- *			position
+ * returns: the number of legal swap pairs found
  *****************************************************************************/
-int getGridPosition (int pos)
+static int legalSwaps(Puzzle &puz, const FreeCells &cells, bool conflicts, int *legal)
 {
-	// row and column containing square in position pos
-	int row = pos / const_data.DIM;
-	int col = pos % const_data.DIM;
-
-	// starting row and column for subgrid containing square in row and col
-	int subgrid_row_start = (row-(row % const_data.SUBDIM));
-	int subgrid_col_start = (col - (col % const_data.SUBDIM));
+	int legal_ct = 0;
+	for (int p = 0; p < cells.pair_count; p++)
+	{
+		const SwapPair &pair = cells.pairs[p];
+		int a = cells.positions[pair.first];
+		int b = cells.positions[pair.second];
+		if (conflicts && !puz.hasConflict(a) && !puz.hasConflict(b))
+			continue;
 
-	// return subgrid position
-	return subgrid_row_start + (subgrid_col_start / const_data.SUBDIM);
-}
\ No newline at end of file
+		if (cells.allows(pair.first, puz.getValue(b)) && cells.allows(pair.second, puz.getValue(a)))
+		{
+			legal[legal_ct++] = p;
+		}
+	}
+	return legal_ct;
+}
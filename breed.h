@@ -9,12 +9,13 @@
 
 #include "globals.h"
 
-void breed();
-void mutateOnly();
-void createNextGeneration(Puzzle&, Puzzle&);
-void addElite(int);
-void addLucky(int);
-void mutate(Puzzle &);
-int getGridPosition (int);
+void breed(Island&);
+void mutateOnly(Island&);
+void createNextGeneration(const ProblemContext&, Puzzle&, Puzzle&, Rng&, int);
+void addElite(Island&, int);
+void addLucky(Island&, int);
+void mutate(const ProblemContext&, Puzzle &, Rng&);
+void improve(const ProblemContext&, Puzzle &, Rng&, int);
+bool randomSwap(const ProblemContext&, Puzzle &, Rng&, int&, int&);
 
 #endif
\ No newline at end of file
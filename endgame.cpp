@@ -0,0 +1,233 @@
+ /************************************************************************
+   File: endgame.cpp
+   Authors: Katie MacMillan, Jake Davidson
+   Description: This file contains the endgame repair search. The moves
+   searched are the same kind the genetic algorithm makes, swaps of free
+   squares within a subgrid, so every subgrid stays a permutation. Only
+   moves which touch a square whose value is duplicated in its row or
+   column are tried, since a move that changes no conflicting square can
+   not remove a duplicate. Like mutation, only moves which leave every
+   value possible in its new square are tried, so a repair never brings
+   back a value preprocessing ruled out. Every move is evaluated with the
+   puzzle's incremental fitness and undone afterwards, so a repair never
+   copies the puzzle.
+ ************************************************************************/
+#include "endgame.h"
+
+/******************************************************************************
+ * Move
+ * A swap of two free squares, or a rotation of three, within one subgrid.
+ * A rotation moves the value of a into b, b into c and c into a.
+ *****************************************************************************/
+struct Move
+{
+	int a;
+	int b;
+	int c; //-1 for a swap of two squares
+};
+
+static void applyMove(Puzzle&, const Move&);
+static void undoMove(Puzzle&, const Move&);
+static bool overlaps(const Move&, const Move&);
+static void listMoves(const ProblemContext&, Puzzle&, vector<Move>&, vector<Move>&);
+
+/******************************************************************************
+ * repairEndgame(const ProblemContext&, Puzzle&)
+ *
+ * This function tries to finish a puzzle that is close to solved. Every swap
+ * and three square rotation within a subgrid which touches a conflicting
+ * square is evaluated, and the one giving the lowest fitness is applied if
+ * it improves the puzzle. This repeats for up to ENDGAME_ROUNDS moves, or
+ * until the puzzle is solved.
+ *
+ * When no single move improves the puzzle, pairs of swaps are tried, since a
+ * puzzle two swaps from the answer often has no improving first swap. Only a
+ * pair of swaps that solves the puzzle outright is kept. Large boards have
+ * far too many pairs to try them all, so at most ENDGAME_PAIR_MOVES pairs
+ * are evaluated.
+ *
+ * Only pairs of swaps on four different squares are tried. Each swap was
+ * checked as legal against the values before either was made, which still
+ * holds when they share no square, so a pair never moves a value anywhere
+ * preprocessing ruled out. Two swaps sharing a square amount to a rotation,
+ * which has already been tried as a single move.
+ *
+ * params:
+ *		problem - the puzzle being solved
+ *			puz - the puzzle to repair, changed in place
+ *
+ * returns: the number of moves evaluated
+ *****************************************************************************/
+int repairEndgame(const ProblemContext &problem, Puzzle &puz)
+{
+	vector<Move> swaps;
+	vector<Move> rotations;
+	int evaluated = 0;
+
+	for (int round = 0; round < ENDGAME_ROUNDS && puz.fitness != 0; round++)
+	{
+		listMoves(problem, puz, swaps, rotations);
+
+		// find the best single move
+		const Move *best = NULL;
+		int best_fitness = puz.fitness;
+		for (int list = 0; list < 2; list++)
+		{
+			const vector<Move> &moves = (list == 0) ? swaps : rotations;
+			for (int i = 0; i < (int)moves.size(); i++)
+			{
+				applyMove(puz, moves[i]);
+				evaluated++;
+				if (puz.fitness < best_fitness)
+				{
+					best_fitness = puz.fitness;
+					best = &moves[i];
+				}
+				undoMove(puz, moves[i]);
+			}
+		}
+
+		if (best != NULL)
+		{
+			applyMove(puz, *best);
+			continue;
+		}
+
+		// no single move helps, so look for two swaps that finish the puzzle
+		int budget = evaluated + ENDGAME_PAIR_MOVES;
+		for (int i = 0; i < (int)swaps.size() && evaluated < budget; i++)
+		{
+			applyMove(puz, swaps[i]);
+			for (int j = i + 1; j < (int)swaps.size() && evaluated < budget; j++)
+			{
+				// swaps sharing a square were listed for the values before either was made
+				if (overlaps(swaps[i], swaps[j]))
+					continue;
+
+				applyMove(puz, swaps[j]);
+				evaluated++;
+				if (puz.fitness == 0)
+					return evaluated;
+				undoMove(puz, swaps[j]);
+			}
+			undoMove(puz, swaps[i]);
+		}
+		break;
+	}
+	return evaluated;
+}
+
+/******************************************************************************
+ * listMoves(const ProblemContext&, Puzzle&, vector<Move>&, vector<Move>&)
+ *
+ * This function lists the swaps and rotations worth trying on a puzzle. For
+ * each subgrid with a conflicting free square, every swap of two free
+ * squares and both rotations of every three free squares which include a
+ * conflicting square are listed, as long as every value moved is possible
+ * in the square it moves to.
+ *
+ * params:
+ *		problem - the puzzle being solved
+ *			puz - the puzzle to list moves for
+ *		  swaps - receives the swaps
+ *	  rotations - receives the rotations
+ *****************************************************************************/
+static void listMoves(const ProblemContext &problem, Puzzle &puz, vector<Move> &swaps, vector<Move> &rotations)
+{
+	swaps.clear();
+	rotations.clear();
+
+	for (int g = 0; g < BOARD_DIM; g++)
+	{
+		const FreeCells &cells = problem.free_cells[g];
+		bool conflict[BOARD_DIM];
+		char value[BOARD_DIM];
+		bool any = false;
+		for (int i = 0; i < cells.count; i++)
+		{
+			conflict[i] = puz.hasConflict(cells.positions[i]);
+			value[i] = puz.getValue(cells.positions[i]);
+			any |= conflict[i];
+		}
+		if (!any)
+			continue;
+
+		for (int i = 0; i < cells.count; i++)
+		{
+			for (int j = i + 1; j < cells.count; j++)
+			{
+				if ((conflict[i] || conflict[j]) && cells.allows(i, value[j]) && cells.allows(j, value[i]))
+				{
+					swaps.push_back({cells.positions[i], cells.positions[j], -1});
+				}
+				for (int k = j + 1; k < cells.count; k++)
+				{
+					if (!conflict[i] && !conflict[j] && !conflict[k])
+						continue;
+
+					// i into j, j into k and k into i, then the other way round
+					if (cells.allows(j, value[i]) && cells.allows(k, value[j]) && cells.allows(i, value[k]))
+					{
+						rotations.push_back({cells.positions[i], cells.positions[j], cells.positions[k]});
+					}
+					if (cells.allows(k, value[i]) && cells.allows(j, value[k]) && cells.allows(i, value[j]))
+					{
+						rotations.push_back({cells.positions[i], cells.positions[k], cells.positions[j]});
+					}
+				}
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * applyMove(Puzzle&, const Move&)
+ *
+ * This function makes a move, updating the puzzle's fitness incrementally.
+ *
+ * params:
+ *		 puz - the puzzle to change
+ *		move - the swap or rotation to make
+ *****************************************************************************/
+static void applyMove(Puzzle &puz, const Move &move)
+{
+	puz.swapSquares(move.a, move.b);
+	if (move.c != -1)
+	{
+		puz.swapSquares(move.a, move.c);
+	}
+}
+
+/******************************************************************************
+ * undoMove(Puzzle&, const Move&)
+ *
+ * This function reverses a move made by applyMove.
+ *
+ * params:
+ *		 puz - the puzzle to change
+ *		move - the swap or rotation to reverse
+ *****************************************************************************/
+static void undoMove(Puzzle &puz, const Move &move)
+{
+	if (move.c != -1)
+	{
+		puz.swapSquares(move.a, move.c);
+	}
+	puz.swapSquares(move.a, move.b);
+}
+
+/******************************************************************************
+ * overlaps(const Move&, const Move&)
+ *
+ * This function checks whether two swaps move any of the same squares.
+ *
+ * params:
+ *		first - a swap
+ *	   second - another swap
+ *
+ * returns: true if the swaps share a square
+ *****************************************************************************/
+static bool overlaps(const Move &first, const Move &second)
+{
+	return first.a == second.a || first.a == second.b || first.b == second.a || first.b == second.b;
+}
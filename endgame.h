@@ -0,0 +1,25 @@
+ /************************************************************************
+   File: endgame.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Function prototypes for endgame repair. When the genetic
+   algorithm stalls a few duplicates away from a solution, the best puzzle
+   is usually only a swap or two from the answer. Endgame repair searches
+   those swaps directly instead of waiting for a lucky mutation.
+ ************************************************************************/
+#ifndef ENDGAME_H_
+#define ENDGAME_H_
+
+#include "globals.h"
+
+// stalled puzzles with at most this fitness are repaired
+const int ENDGAME_FITNESS = 2;
+// stagnant generations before a stalled puzzle is repaired
+const int ENDGAME_STALL = 10;
+// most improving moves applied in one repair
+const int ENDGAME_ROUNDS = 8;
+// most pairs of swaps evaluated when no single move helps
+const int ENDGAME_PAIR_MOVES = 100000;
+
+int repairEndgame(const ProblemContext&, Puzzle&);
+
+#endif
@@ -0,0 +1,156 @@
+ /************************************************************************
+   File: exactsolver.cpp
+   Authors: Katie MacMillan, Jake Davidson
+   Description: This file contains the exact backtracking solver. The
+   search state is one bitmask of used values for each row, column and
+   subgrid, plus the list of blank squares. The possible values of a
+   square are the values missing from all three of its masks, so they are
+   found with two ORs and a popcount rather than by scanning the puzzle.
+ ************************************************************************/
+#include "exactsolver.h"
+
+/******************************************************************************
+ * SearchState
+ * The bitmasks and blank squares of a puzzle being searched. Bit i of a
+ * mask is set if the value with index i is already in that unit. The blank
+ * squares before 'filled' have been filled by the search so far.
+ *****************************************************************************/
+struct SearchState
+{
+	uint32_t rows[BOARD_DIM]; //values used in each row
+	uint32_t cols[BOARD_DIM]; //values used in each column
+	uint32_t boxes[BOARD_DIM]; //values used in each subgrid
+	int blanks[BOARD_SQUARES]; //1D positions of the blank squares
+	int blank_ct; //number of blank squares
+	long long nodes; //number of values tried
+};
+
+static const uint32_t ALL_VALUES = (uint32_t)((1ull << BOARD_DIM) - 1);
+
+static bool search(SearchState&, Puzzle&, int);
+
+/******************************************************************************
+ * solveExact(Puzzle&, long long&)
+ *
+ * This function fills in every blank square of a puzzle so that no row,
+ * column or subgrid holds a value twice. The masks are built from the
+ * filled squares, and the search then fills the blanks one at a time.
+ *
+ * params:
+ *		  puz - the puzzle to solve, filled in place if a solution is found
+ *		nodes - receives the number of values tried during the search
+ *
+ * returns: true if the puzzle was solved, false if it has no solution (the
+ *			puzzle is left unchanged)
+ *****************************************************************************/
+bool solveExact(Puzzle &puz, long long &nodes)
+{
+	SearchState state;
+	fill(state.rows, state.rows + BOARD_DIM, 0);
+	fill(state.cols, state.cols + BOARD_DIM, 0);
+	fill(state.boxes, state.boxes + BOARD_DIM, 0);
+	state.blank_ct = 0;
+	state.nodes = 0;
+
+	bool valid = true;
+	for (int pos = 0; pos < BOARD_SQUARES; pos++)
+	{
+		int v = valueIndex(puz.getValue(pos));
+		if (v < 0 || v >= BOARD_DIM)
+		{
+			state.blanks[state.blank_ct++] = pos;
+			continue;
+		}
+
+		// a given repeated in a unit can never be solved
+		uint32_t bit = 1u << v;
+		uint32_t &row = state.rows[BOARD.row[pos]];
+		uint32_t &col = state.cols[BOARD.col[pos]];
+		uint32_t &box = state.boxes[BOARD.box[pos]];
+		if ((row | col | box) & bit)
+			valid = false;
+		row |= bit;
+		col |= bit;
+		box |= bit;
+	}
+
+	Puzzle work = puz;
+	bool solved = valid && search(state, work, 0);
+	nodes = state.nodes;
+	if (solved)
+	{
+		puz = work;
+		puz.evaluateFitness();
+	}
+	return solved;
+}
+
+/******************************************************************************
+ * search(SearchState&, Puzzle&, int)
+ *
+ * This function fills the remaining blank squares by depth first search.
+ * The blank square with the fewest possible values is moved to position
+ * 'depth' of the blank list and each of its possible values is tried in
+ * turn. A square with no possible values ends the branch straight away, and
+ * a square with a single possible value costs no branching at all.
+ *
+ * params:
+ *		state - the masks and blank squares of the search
+ *		  puz - the puzzle being filled in
+ *		depth - the number of blank squares already filled
+ *
+ * returns: true once every blank square is filled, false if this branch
+ *			has no solution
+ *****************************************************************************/
+static bool search(SearchState &state, Puzzle &puz, int depth)
+{
+	if (depth == state.blank_ct)
+		return true;
+
+	// pick the most constrained blank square
+	int best = depth;
+	int best_ct = BOARD_DIM + 1;
+	uint32_t best_options = 0;
+	for (int i = depth; i < state.blank_ct; i++)
+	{
+		int pos = state.blanks[i];
+		uint32_t used = state.rows[BOARD.row[pos]] | state.cols[BOARD.col[pos]] | state.boxes[BOARD.box[pos]];
+		uint32_t options = ALL_VALUES & ~used;
+		int ct = __builtin_popcount(options);
+		if (ct < best_ct)
+		{
+			best = i;
+			best_ct = ct;
+			best_options = options;
+			if (ct <= 1)
+				break;
+		}
+	}
+	if (best_ct == 0)
+		return false;
+
+	swap(state.blanks[depth], state.blanks[best]);
+	int pos = state.blanks[depth];
+	uint32_t &row = state.rows[BOARD.row[pos]];
+	uint32_t &col = state.cols[BOARD.col[pos]];
+	uint32_t &box = state.boxes[BOARD.box[pos]];
+
+	for (uint32_t m = best_options; m != 0; m &= m - 1)
+	{
+		uint32_t bit = m & -m;
+		state.nodes++;
+		row |= bit;
+		col |= bit;
+		box |= bit;
+		puz.setValue(pos, valueSymbol(__builtin_ctz(m)));
+
+		if (search(state, puz, depth + 1))
+			return true;
+
+		row &= ~bit;
+		col &= ~bit;
+		box &= ~bit;
+	}
+	puz.setValue(pos, '-');
+	return false;
+}
@@ -0,0 +1,18 @@
+ /************************************************************************
+   File: exactsolver.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Function prototypes for the exact solver. The exact solver
+   is a depth first backtracking search which keeps the values used in
+   each row, column and subgrid as bitmasks, and always fills the blank
+   square with the fewest possible values next. It is deterministic and
+   always finds a solution if there is one, which makes it a baseline to
+   compare the genetic algorithm against.
+ ************************************************************************/
+#ifndef EXACTSOLVER_H_
+#define EXACTSOLVER_H_
+
+#include "puzzle.h"
+
+bool solveExact(Puzzle&, long long&);
+
+#endif
@@ -0,0 +1,134 @@
+ /************************************************************************
+   File: genome.cpp
+   Authors: Katie MacMillan, Jake Davidson
+   Description: This file contains the binary genome encoding. Free
+   squares are visited in the order of the problem context's free square
+   lists, so encoding and decoding only work between processes which
+   preprocessed the same puzzle the same way. puzzleHash() lets processes
+   check this before trading genomes.
+ ************************************************************************/
+#include "genome.h"
+
+/******************************************************************************
+ * genomeLength(const ProblemContext&)
+ *
+ * This function finds the number of bytes a genome takes for the puzzle
+ * being solved.
+ *
+ * params:
+ *		problem - the puzzle being solved
+ *
+ * returns: the genome length in bytes
+ *****************************************************************************/
+int genomeLength(const ProblemContext &problem)
+{
+	int free_squares = 0;
+	for (int g = 0; g < BOARD_DIM; g++)
+	{
+		free_squares += problem.free_cells[g].count;
+	}
+	return ((free_squares * GENOME_VALUE_BITS) + 7) / 8;
+}
+
+/******************************************************************************
+ * encodeGenome(const ProblemContext&, const Puzzle&, uint8_t*)
+ *
+ * This function packs the values of a puzzle's free squares into a genome.
+ * Each value is written as its index in the subgrid's list of missing
+ * values, GENOME_VALUE_BITS at a time.
+ *
+ * params:
+ *		problem - the puzzle being solved
+ *			puz - the puzzle to encode
+ *		 genome - receives genomeLength() bytes
+ *****************************************************************************/
+void encodeGenome(const ProblemContext &problem, const Puzzle &puz, uint8_t *genome)
+{
+	fill(genome, genome + genomeLength(problem), 0);
+
+	int bit = 0;
+	for (int g = 0; g < BOARD_DIM; g++)
+	{
+		const FreeCells &cells = problem.free_cells[g];
+		for (int i = 0; i < cells.count; i++)
+		{
+			char value = puz.getValue(cells.positions[i]);
+			int index = find(cells.values, cells.values + cells.count, value) - cells.values;
+			for (int b = 0; b < GENOME_VALUE_BITS; b++, bit++)
+			{
+				if ((index >> b) & 1)
+				{
+					genome[bit / 8] |= 1 << (bit % 8);
+				}
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ * decodeGenome(const ProblemContext&, const uint8_t*, Puzzle&)
+ *
+ * This function rebuilds a puzzle from a genome. The preset squares come
+ * from the initial puzzle and the free squares from the genome. A genome
+ * is rejected unless every subgrid decodes to a permutation, so a corrupt
+ * or mismatched genome can never enter a population. The puzzle's fitness
+ * is evaluated.
+ *
+ * params:
+ *		problem - the puzzle being solved
+ *		 genome - the genome to decode
+ *			puz - receives the decoded puzzle
+ *
+ * returns: true if the genome was valid
+ *****************************************************************************/
+bool decodeGenome(const ProblemContext &problem, const uint8_t *genome, Puzzle &puz)
+{
+	puz = problem.initial_puzzle;
+
+	int bit = 0;
+	for (int g = 0; g < BOARD_DIM; g++)
+	{
+		const FreeCells &cells = problem.free_cells[g];
+		uint32_t used = 0;
+		for (int i = 0; i < cells.count; i++)
+		{
+			int index = 0;
+			for (int b = 0; b < GENOME_VALUE_BITS; b++, bit++)
+			{
+				index |= ((genome[bit / 8] >> (bit % 8)) & 1) << b;
+			}
+			if (index >= cells.count || ((used >> index) & 1))
+				return false;
+
+			used |= 1u << index;
+			puz.setValue(cells.positions[i], cells.values[index]);
+		}
+	}
+	puz.evaluateFitness();
+	return true;
+}
+
+/******************************************************************************
+ * puzzleHash(const ProblemContext&)
+ *
+ * This function hashes the board size, the number of migrants traded at
+ * each migration and the preprocessed initial puzzle with FNV-1a. Processes
+ * only trade genomes when their hashes match, so a ring never holds more or
+ * fewer migrants than its islands expect.
+ *
+ * params:
+ *		problem - the puzzle being solved
+ *
+ * returns: the hash of the puzzle being solved
+ *****************************************************************************/
+uint32_t puzzleHash(const ProblemContext &problem)
+{
+	uint32_t hash = 2166136261u;
+	hash = (hash ^ BOARD_ORDER) * 16777619u;
+	hash = (hash ^ ISLAND_MIGRANTS) * 16777619u;
+	for (int pos = 0; pos < BOARD_SQUARES; pos++)
+	{
+		hash = (hash ^ (uint8_t)problem.initial_puzzle.getValue(pos)) * 16777619u;
+	}
+	return hash;
+}
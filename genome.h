@@ -0,0 +1,27 @@
+ /************************************************************************
+   File: genome.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Function prototypes for the binary genome format used to
+   send puzzles between processes. Every process solving the same puzzle
+   shares the same preset squares, so a genome only holds the values of
+   the free squares, and each of those only as its index among the values
+   missing from its subgrid, packed into as few bits as the board needs.
+   A 9x9 puzzle with 50 free squares packs into 25 bytes.
+ ************************************************************************/
+#ifndef GENOME_H_
+#define GENOME_H_
+
+#include "globals.h"
+#include "migration.h"
+
+// bits used for each free square
+const int GENOME_VALUE_BITS = (BOARD_DIM <= 4) ? 2 : (BOARD_DIM <= 16) ? 4 : 5;
+// largest genome any puzzle of this board size can encode to
+const int GENOME_BYTES = ((BOARD_SQUARES * GENOME_VALUE_BITS) + 7) / 8;
+
+int genomeLength(const ProblemContext&);
+void encodeGenome(const ProblemContext&, const Puzzle&, uint8_t*);
+bool decodeGenome(const ProblemContext&, const uint8_t*, Puzzle&);
+uint32_t puzzleHash(const ProblemContext&);
+
+#endif
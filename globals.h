@@ -1,10 +1,13 @@
  /************************************************************************
    File: globals.h
    Authors: Katie MacMillian, Jake Davidson
-   Description: Stores global program information and variables. The ConstData 
-   struct holds constant info about the puzzle size and genetic algorithm params.
-   It also stores the initial puzzle state, the current and next populations in 
-   the breed phase, and the current mutation rate.
+   Description: Stores the program's shared types. The Params struct
+   holds constant info about the puzzle size and genetic algorithm params.
+   The Island struct holds the current and next populations in the breed
+   phase, the fitness ranking of the current population, the current
+   mutation rate and random number generator, and the problem context and
+   params of the puzzle being solved. Nothing here is global, so several
+   puzzles can be solved at once, each with its own params.
  ************************************************************************/
 #ifndef GLOBALS_H_
 #define GLOBALS_H_
@@ -22,20 +25,23 @@
 #include <iomanip>
 #include <thread>
 
+#include "boardorder.h"
 #include "square.h"
 #include "puzzle.h"
+#include "problemcontext.h"
+#include "rng.h"
 
 /******************************************************************************
- * ConstData
- * This is a structure to hold "constant" data for the program. This is data
- * that is set at the begining of the program execution, possibly by the user,
- * but then remains constant throughout the remainder of the program execution.
- * The values contained here are the default values for the program.
+ * Params
+ * This is a structure to hold "constant" data for a solve. This is data
+ * that is set before the solve begins, possibly by the user, but then
+ * remains constant throughout the remainder of the solve. The values
+ * contained here are the default values for the program.
  *****************************************************************************/
-struct ConstData{
-	const int DIM = 9; //9x9 puzzle
-	const int SUBDIM = 3; //sugrids are 3x3
-	const vector<char> VALUE_SET = {'1', '2', '3', '4', '5', '6', '7', '8', '9'}; //permute using these values
+struct Params{
+	const int DIM = BOARD_DIM; //9x9 puzzle unless built for another board order
+	const int SUBDIM = BOARD_SUBDIM; //sugrids are 3x3
+	const vector<char> VALUE_SET = vector<char>(VALUE_SYMBOLS, VALUE_SYMBOLS + BOARD_DIM); //permute using these values
 
 	int POP = 1000; //default pop size
 	int GENERATIONS = 1000; //default number of generations
@@ -46,16 +52,38 @@ struct ConstData{
 	bool ELITISM_FLAG = true; //carry over top percentage of previous population
 	bool MUTATE_ONLY_FLAG = false; //if true, only mutate when making new generations
 	int START_MUTATE = 5; //starting mutation rate (expressed as integer percentage)
+	uint64_t SEED = 0; //master random seed, the same seed reproduces the same run
+	uint64_t STREAM = 0; //stream of the seed to draw from, so solves sharing a seed can differ
+	int PREPROCESS = 2; //0 = no preprocessing, 1 = singles only, 2 = all techniques
+	int ENGINE = 0; //0 = genetic algorithm, 1 = exact backtracking search, 2 = simulated annealing
+	int LOCAL_SEARCH = 0; //swaps tried on each child by local search, 0 = off
+	int ISLANDS = 1; //number of populations evolved at once, one per thread
+	int MIGRATION = 10; //generations between migrations between islands
+	int RANK = 0; //this process's position in a ring of island processes
+	int RANKS = 1; //number of processes in a shared memory ring
+	string SHM_NAME = ""; //shared memory segment linking island processes, empty = none
+	string LISTEN = ""; //address to accept the process before on, empty = no socket ring
+	string CONNECT = ""; //address of the next process in a socket ring
+	int BATCH = -1; //worker threads solving a batch of puzzles, 0 = one per core, -1 = a single puzzle
+	bool VERBOSE = false; //print the puzzle, progress and results as the solve goes
 };
 
-
-extern Puzzle initial_puzzle; //the puzzle we are solving in it's init state
-extern vector<Puzzle> population; //list of puzzles that make up our current population
-extern vector<Puzzle> new_generation; //the next generation of puzzles created from population
-extern vector<Puzzle> breeding_pool; //list to store current breeders
-extern int mutation_rate; //rate at which mutations will occur
-
-// program constants
-extern ConstData const_data;
+/******************************************************************************
+ * Island
+ * One population evolved by the genetic algorithm, along with the breeding
+ * scratch space and the random stream it is bred from. A normal run evolves
+ * a single island, and the island model evolves several at once.
+ *****************************************************************************/
+struct Island
+{
+	vector<Puzzle> population; //list of puzzles that make up the current population
+	vector<Puzzle> new_generation; //the next generation of puzzles created from population
+	vector<int> breeding_pool; //indices into population of the current breeders
+	vector<int> ranking; //indices into population, ordered by ascending fitness
+	int mutation_rate; //rate at which mutations will occur
+	Rng rng; //serial random number generator for this island
+	const ProblemContext *problem; //the puzzle the island is solving
+	const Params *params; //the params the island is bred with
+};
 
 #endif
\ No newline at end of file
@@ -0,0 +1,340 @@
+ /************************************************************************
+   File: islands.cpp
+   Authors: Katie MacMillan, Jake Davidson
+   Description: This file contains the island model. Each island breeds
+   and ranks its own population with the same functions as a single
+   population run, so the only new work is the migration between
+   islands. Islands on threads of this process pass migrants through a
+   single producer, single consumer queue between each island and the
+   next, so passing them on never takes a lock. An island in a ring of
+   processes trades migrants through whichever channel it is given.
+ ************************************************************************/
+#include "islands.h"
+#include "population.h"
+#include "breed.h"
+#include "endgame.h"
+#include "spscqueue.h"
+#include <atomic>
+#include <mutex>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/******************************************************************************
+ * IslandResult
+ * What one island found, written only by that island's thread.
+ *****************************************************************************/
+struct IslandResult
+{
+	Puzzle best; //best puzzle the island found
+	int best_generation = 0; //generation the best puzzle was found in
+	int generations = 0; //generations the island bred
+};
+
+/******************************************************************************
+ * QueueChannel
+ * The migration channel between islands on threads of one process. Each
+ * island owns the queue to the next island, and all islands share one
+ * solved flag.
+ *****************************************************************************/
+class QueueChannel : public MigrationChannel
+{
+	public:
+		QueueChannel(SpscQueue<Puzzle> &outbound, SpscQueue<Puzzle> &inbound, atomic<bool> &solved)
+			: _outbound(outbound), _inbound(inbound), _solved(solved) {}
+
+		bool send(const Puzzle &puz) { return _outbound.push(puz); }
+		ReceiveResult receive(Puzzle &puz) { return _inbound.pop(puz) ? RECEIVE_MIGRANT : RECEIVE_NOTHING; }
+		void announceSolved() { _solved.store(true); }
+		bool stopped() { return _solved.load(memory_order_relaxed); }
+
+	private:
+		SpscQueue<Puzzle> &_outbound; //migrants to the next island
+		SpscQueue<Puzzle> &_inbound; //migrants from the island before
+		atomic<bool> &_solved; //set once any island solves the puzzle
+};
+
+static void evolveIsland(Island&, MigrationChannel&, IslandResult&, int);
+static bool migrate(Island&, MigrationChannel&);
+
+// keeps progress lines from different islands apart
+static mutex output_lock;
+
+/******************************************************************************
+ * runIslands(const ProblemContext&, const Params&, Rng&, Puzzle&, int&)
+ *
+ * This function evolves params.ISLANDS populations at once, each on its
+ * own thread, until one of them solves the puzzle or every island has bred
+ * the maximum number of generations. Every island draws its random numbers
+ * from its own stream of a seed taken from the given generator, and the
+ * cores are shared out between islands for their parallel breeding loops.
+ *
+ * A stagnant island restarts with a whole new population, as a single
+ * population run does. Its best puzzle is already kept in its result and
+ * has been passed on to the next island as a migrant, so nothing the island
+ * found is lost, and the new population soon receives migrants again.
+ *
+ * params:
+ *		   problem - the puzzle being solved
+ *			params - the params every island is bred with
+ *			   rng - the generator the islands' seed is drawn from
+ *			  best - receives the best puzzle found by any island
+ *	best_generation - receives the generation that puzzle was found in
+ *
+ * returns: the number of generations bred by all islands together
+ *****************************************************************************/
+long long runIslands(const ProblemContext &problem, const Params &params, Rng &rng, Puzzle &best, int &best_generation)
+{
+	int n = params.ISLANDS;
+	vector<Island> islands(n);
+	vector<SpscQueue<Puzzle> > queues(n); //queues[i] carries migrants from island i to the next island
+	vector<IslandResult> results(n);
+	atomic<bool> solved(false);
+
+	// an island can run at most a lap of the ring ahead of the next island
+	uint64_t islands_seed = rng.next();
+	for (int i = 0; i < n; i++)
+	{
+		initIsland(islands[i], problem, params, Rng(islands_seed, i));
+		queues[i].reserve(ISLAND_MIGRANTS * (n + 1));
+	}
+
+	// share the cores out between the islands' breeding loops
+	int omp_threads = 1;
+#ifdef _OPENMP
+	omp_threads = max(1, omp_get_max_threads() / n);
+#endif
+
+	vector<thread> threads;
+	for (int i = 0; i < n; i++)
+	{
+		threads.push_back(thread([&, i]() {
+#ifdef _OPENMP
+			omp_set_num_threads(omp_threads);
+#endif
+			QueueChannel channel(queues[i], queues[(i + n - 1) % n], solved);
+			evolveIsland(islands[i], channel, results[i], i);
+		}));
+	}
+	for (int i = 0; i < n; i++)
+	{
+		threads[i].join();
+	}
+
+	// report the best island, the one that got there first on a tie
+	long long total = 0;
+	int winner = 0;
+	for (int i = 0; i < n; i++)
+	{
+		total += results[i].generations;
+		const IslandResult &w = results[winner];
+		if ((results[i].best.fitness < w.best.fitness) ||
+			(results[i].best.fitness == w.best.fitness && results[i].best_generation < w.best_generation))
+		{
+			winner = i;
+		}
+	}
+	best = results[winner].best;
+	best_generation = results[winner].best_generation;
+	return total;
+}
+
+/******************************************************************************
+ * runLinkedIsland(const ProblemContext&, const Params&, Rng&, MigrationChannel&, int, Puzzle&, int&)
+ *
+ * This function evolves this process's island in a ring of island
+ * processes, trading migrants through the given channel. Each process's
+ * island draws from its own stream, chosen by its rank, of a seed taken
+ * from the given generator, so processes started with the same seed still
+ * search differently.
+ *
+ * params:
+ *		  problem - the puzzle being solved
+ *		   params - the params the island is bred with
+ *			  rng - the generator the island's seed is drawn from
+ *		  channel - the channel to the neighbouring processes
+ *			 rank - this process's position in the ring
+ *			 best - receives the best puzzle the island found
+ *	best_generation - receives the generation that puzzle was found in
+ *
+ * returns: the number of generations the island bred
+ *****************************************************************************/
+long long runLinkedIsland(const ProblemContext &problem, const Params &params, Rng &rng, MigrationChannel &channel, int rank, Puzzle &best, int &best_generation)
+{
+	Island island;
+	IslandResult result;
+	initIsland(island, problem, params, Rng(rng.next(), rank));
+
+	evolveIsland(island, channel, result, rank);
+
+	best = result.best;
+	best_generation = result.best_generation;
+	return result.generations;
+}
+
+/******************************************************************************
+ * evolveIsland(Island&, MigrationChannel&, IslandResult&, int)
+ *
+ * This function evolves one island. The island breeds generations the same
+ * way a single population run does, raising its mutation rate by 5% for
+ * each generation past 15 without a change in its best fitness, and
+ * handing a best puzzle stalled close to the answer to the endgame repair
+ * search. An island stagnant for ISLAND_RESTART_STALL generations is
+ * restarted with a new population, since any of its own puzzles kept would
+ * soon breed it back onto the same plateau. Every params.MIGRATION
+ * generations it trades migrants with its neighbours. It stops once any
+ * island has solved the puzzle.
+ *
+ * params:
+ *			isl - the island to evolve
+ *		channel - the island's channel to its neighbours
+ *		 result - receives what the island found
+ *			 id - the island's number, for progress lines
+ *****************************************************************************/
+static void evolveIsland(Island &isl, MigrationChannel &channel, IslandResult &result, int id)
+{
+	const Params &params = *isl.params;
+
+	getInitialPop(isl);
+	fitness(isl);
+	result.best = isl.population[isl.ranking[0]];
+
+	int best_fitness = result.best.fitness;
+	int best_fitness_ct = 0;
+	for (int generation = 0; generation < params.GENERATIONS; generation++)
+	{
+		if (channel.stopped())
+			break;
+
+		if (params.MUTATE_ONLY_FLAG)
+		{
+			mutateOnly(isl);
+		}
+		else
+		{
+			breed(isl);
+		}
+		fitness(isl);
+		result.generations++;
+
+		// raise the mutation rate while the island is stagnant
+		const Puzzle &top = isl.population[isl.ranking[0]];
+		if (top.fitness == best_fitness)
+		{
+			best_fitness_ct++;
+			if ((best_fitness_ct > 15) && (isl.mutation_rate < 100))
+			{
+				isl.mutation_rate += 5;
+			}
+		}
+		else
+		{
+			best_fitness_ct = 0;
+			isl.mutation_rate = params.START_MUTATE;
+		}
+		best_fitness = top.fitness;
+
+		// a puzzle stalled close to the answer is usually a swap or two away, so search for them directly
+		if ((best_fitness_ct == ENDGAME_STALL) && (best_fitness <= ENDGAME_FITNESS))
+		{
+			Puzzle &stalled = isl.population[isl.ranking[0]];
+			int before = stalled.fitness;
+			repairEndgame(*isl.problem, stalled);
+			if (stalled.fitness < before)
+			{
+				best_fitness = stalled.fitness;
+				best_fitness_ct = 0;
+				isl.mutation_rate = params.START_MUTATE;
+			}
+		}
+
+		// breeding and migrants alone have not moved the island off its plateau, so start it again
+		if (best_fitness_ct >= ISLAND_RESTART_STALL)
+		{
+			getInitialPop(isl);
+			fitness(isl);
+			best_fitness = isl.population[isl.ranking[0]].fitness;
+			best_fitness_ct = 0;
+			isl.mutation_rate = params.START_MUTATE;
+		}
+
+		const Puzzle &best = isl.population[isl.ranking[0]];
+		if (best.fitness < result.best.fitness)
+		{
+			result.best = best;
+			result.best_generation = generation;
+
+			if (params.VERBOSE)
+			{
+				lock_guard<mutex> lock(output_lock);
+				cout << "Island" << right << setw(3) << id << ", generation" << right << setw(5) << generation;
+				cout << ": best score =" << right << setw(3) << best.fitness << endl;
+			}
+		}
+		if (best.fitness == 0)
+		{
+			channel.announceSolved();
+			break;
+		}
+
+		if ((generation + 1) % params.MIGRATION == 0)
+		{
+			if (!migrate(isl, channel))
+				break;
+		}
+	}
+}
+
+/******************************************************************************
+ * migrate(Island&, MigrationChannel&)
+ *
+ * This function sends copies of an island's ISLAND_MIGRANTS best puzzles to
+ * the next island, and then replaces its own worst puzzles with the migrants
+ * from the island before it. The island waits for those migrants, so each
+ * island receives the same migrants in the same generation on every run
+ * with the same seed. Migrants are sent before any are received, so the
+ * ring can never deadlock. A waiting island gives up if the puzzle is
+ * solved in the meantime.
+ *
+ * Exactly ISLAND_MIGRANTS are always sent and taken, whatever the
+ * population size, so every island in the ring agrees on how many are in
+ * flight. A migrant the channel had to drop still counts as taken, and
+ * leaves the worst puzzle it would have replaced in place.
+ *
+ * params:
+ *			 isl - the island trading migrants
+ *		 channel - the island's channel to its neighbours
+ *
+ * returns: false if the island gave up because the islands were stopped
+ *****************************************************************************/
+static bool migrate(Island &isl, MigrationChannel &channel)
+{
+	int size = isl.ranking.size();
+
+	// send the best puzzles on before anything is overwritten
+	for (int m = 0; m < ISLAND_MIGRANTS; m++)
+	{
+		while (!channel.send(isl.population[isl.ranking[m % size]]))
+		{
+			if (channel.stopped())
+				return false;
+			this_thread::yield();
+		}
+	}
+
+	// the migrants take the places of the worst puzzles
+	for (int m = 0; m < ISLAND_MIGRANTS; m++)
+	{
+		Puzzle &worst = isl.population[isl.ranking[size - 1 - (m % size)]];
+		while (channel.receive(worst) == RECEIVE_NOTHING)
+		{
+			if (channel.stopped())
+				return false;
+			this_thread::yield();
+		}
+	}
+
+	// migrants carry their fitness with them, so only the ranking changes
+	fitness(isl);
+	return true;
+}
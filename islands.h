@@ -0,0 +1,42 @@
+ /************************************************************************
+   File: islands.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Function prototypes for the island model. Each island is
+   a separate population evolved on its own thread from its own random
+   stream. Every few generations each island sends copies of its best
+   puzzles to the next island around a ring, where they replace the
+   worst. There is no barrier between generations, only between
+   migrations.
+
+   An island waits for the migrants from the island before it at every
+   migration, and that island waited for the one before it, so every K
+   generations the ring moves at the pace of its slowest island, which is
+   in effect a ring-wide barrier. Islands may drift apart by up to K
+   generations in between. The wait is the price of reproducibility:
+   each island takes in the same migrants in the same generation on every
+   run with the same seed, however the islands are scheduled. Making the
+   receive non-blocking would remove the barrier, but runs would then
+   depend on thread and process timing.
+
+   The ring as a whole is never restarted, so the diversity spread over
+   the islands is kept. Only a single island whose best fitness has stood
+   still for ISLAND_RESTART_STALL generations restarts, and by then its
+   population has collapsed into one basin: nothing in it is more than a
+   couple of duplicates worse than its best, and keeping any of it, even
+   only the elite or the latest migrants, breeds the island straight back
+   onto the same plateau. The new population takes in the other islands'
+   diversity again through migration.
+ ************************************************************************/
+#ifndef ISLANDS_H_
+#define ISLANDS_H_
+
+#include "globals.h"
+#include "migration.h"
+
+// generations without a change in an island's best fitness before that island alone restarts
+const int ISLAND_RESTART_STALL = 30;
+
+long long runIslands(const ProblemContext&, const Params&, Rng&, Puzzle&, int&);
+long long runLinkedIsland(const ProblemContext&, const Params&, Rng&, MigrationChannel&, int, Puzzle&, int&);
+
+#endif
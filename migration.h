@@ -0,0 +1,47 @@
+ /************************************************************************
+   File: migration.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Header file for the MigrationChannel interface. An island
+   trades migrants with its neighbours through a channel: it sends its
+   best puzzles to the next island and receives puzzles from the island
+   before it. The channel also carries word that some island has solved
+   the puzzle. Islands on threads of one process use in memory queues,
+   and islands in separate processes use shared memory or sockets, but
+   the island itself is the same either way.
+
+   Usage: Derive a channel from MigrationChannel. send() and receive()
+   must never block, returning false or RECEIVE_NOTHING when the puzzle
+   can not be sent or nothing has arrived, so that a waiting island can
+   keep checking stopped(). A migrant which arrives but can not be used
+   is reported as RECEIVE_DROPPED, so the island still counts it and
+   never waits for a migrant that will not come.
+ ************************************************************************/
+#ifndef __MIGRATION_H_
+#define __MIGRATION_H_
+
+#include "puzzle.h"
+
+// best puzzles each island sends to the next at every migration, which
+// every process in a ring must agree on
+const int ISLAND_MIGRANTS = 2;
+
+// what receive() found waiting from the island before
+enum ReceiveResult
+{
+	RECEIVE_NOTHING, //no migrant has arrived yet
+	RECEIVE_MIGRANT, //a migrant arrived and was taken
+	RECEIVE_DROPPED //a migrant arrived but could not be decoded, so it was thrown away
+};
+
+class MigrationChannel
+{
+	public:
+		virtual ~MigrationChannel() {}
+
+		virtual bool send(const Puzzle&) = 0; //send a migrant to the next island, false if it can not be sent yet
+		virtual ReceiveResult receive(Puzzle&) = 0; //take a migrant from the island before, leaving the puzzle alone unless one was taken
+		virtual void announceSolved() = 0; //tell the other islands the puzzle is solved
+		virtual bool stopped() = 0; //true once the islands should stop, because the puzzle is solved or a neighbour is gone
+};
+
+#endif
@@ -7,98 +7,155 @@
 #include "population.h"
 
 /******************************************************************************
- * getInitialPop()
+ * initIsland(Island&, const ProblemContext&, const Params&, const Rng&)
  *
- * This function generates puzzles to fill the population vector. To create a
- * new puzzle, a temporary puzzle is created and set to the value of the
- * initial puzzle. Then for each subgrid in the new puzzle, a copy of the
- * possible values (1-9) is made, and all preset values in the subgrid are
- * removed from the temporary set. 
+ * This function sets up an island before its first population is generated.
+ * The population and new generation are filled with copies of the initial
+ * puzzle up front, so that breeding only ever overwrites puzzles in place
+ * rather than pushing back and rebuilding vectors.
  *
- * The remaining values in the temporary set are then shuffled and each empty
- * square in the subgrid is filled in with one of the remaining values in the
- * temporary set. This ensures that each subgrid in each puzzle is a
- * permutation of 1 though 9.
+ * params:
+ *		    isl - the island to set up
+ *		problem - the puzzle the island solves
+ *		 params - the params the island is bred with
+ *		    rng - the random number stream the island breeds from
  *****************************************************************************/
-void getInitialPop()
+void initIsland(Island &isl, const ProblemContext &problem, const Params &params, const Rng &rng)
 {
-	for (int pop = 0; pop < const_data.POP; pop++) 
-	{
-		vector<char> temp_set = const_data.VALUE_SET;
-		Puzzle temp_puzzle = initial_puzzle;
-		vector<char>::iterator it;
-		vector<square> subgrid;
-
-		for(int r = 0; r < const_data.DIM; r+=3){
-			for(int c = 0; c < const_data.DIM; c+=3){
-				subgrid = temp_puzzle.getSub(r,c);
-				temp_set = const_data.VALUE_SET;
-
-				// remove all in place elements from the value set
-				for(int i = 0; i < subgrid.size(); i++){
-					temp_set = eraseSetValue(temp_set, subgrid[i].getValue());
-				}
-				// randomize remaining value set
-				random_shuffle(temp_set.begin(), temp_set.end());
+	isl.population.assign(params.POP, problem.initial_puzzle);
+	isl.new_generation.assign(params.POP, problem.initial_puzzle);
+	isl.breeding_pool.resize(params.BREEDERS);
+	isl.ranking.clear();
+	isl.mutation_rate = params.START_MUTATE;
+	isl.rng = rng;
+	isl.problem = &problem;
+	isl.params = &params;
+}
 
-				// fill empty squares with remaining set values
-				for(int i = 0; i < subgrid.size(); i++){
-					if(subgrid[i].getValue() == '-'){
-						// set square value to first value in set
-						subgrid[i].setValue(temp_set.back());
-						// remove used value from set
-						temp_set.pop_back();
-					}
-				}
-				temp_puzzle.setSub(r, c, subgrid);
+/******************************************************************************
+ * getInitialPop(Island&)
+ *
+ * This function generates puzzles to fill the population vector. The free
+ * positions and missing values of each subgrid of the initial puzzle are
+ * found once, after preprocessing. Each new puzzle is then a copy of the initial puzzle,
+ * written straight into its slot in the population, with every subgrid's
+ * missing values placed into its blank squares. This ensures that each
+ * subgrid in each puzzle is a permutation of every value (1 though 9 on a 
+ * 9x9 board).
+ *
+ * Missing values are only placed in squares where preprocessing left them
+ * possible, see randomPuzzle().
+ *
+ * Puzzles are generated and evaluated in parallel without any allocation.
+ * Each puzzle draws from its own random stream, derived from a per
+ * population seed and the puzzle's index, so the population only depends on
+ * the master seed. Evaluating a puzzle also builds the row and column
+ * tallies its children's fitness is updated from, so this is the only full
+ * evaluation a puzzle will ever need.
+ *
+ * params:
+ *		isl - the island to fill with a new population
+ *****************************************************************************/
+void getInitialPop(Island &isl)
+{
+	// every puzzle derives its own random stream from this population's seed
+	uint64_t population_seed = isl.rng.next();
 
-			}
-		}
-		population[pop] = temp_puzzle;
+	#pragma omp parallel for
+	for (int pop = 0; pop < isl.params->POP; pop++) 
+	{
+		Rng rng(population_seed, pop);
+		randomPuzzle(*isl.problem, isl.population[pop], rng);
+		isl.population[pop].evaluateFitness();
 	}
 }
 
 /******************************************************************************
- * fitness()
+ * randomPuzzle(const ProblemContext&, Puzzle&, Rng&)
  *
- * This function calls the puzzle class' evaluate fitness function on each
- * puzzle in the population vector. When this is completed it then sorts
- * the vector in ascending order based on fitness.
+ * This function makes a copy of the initial puzzle with the missing values of
+ * every subgrid placed into its free squares. Values are only placed where
+ * preprocessing left them possible. The free squares and missing values of
+ * each subgrid are shuffled, and then matched to each other in that order, so
+ * every puzzle gets a different random assignment of possible values. Should
+ * no such assignment exist the missing values are simply shuffled into place.
+ *
+ * The puzzle's fitness is not evaluated, so that a whole population can be
+ * evaluated at once.
+ *
+ * params:
+ * 	problem - the puzzle being solved
+ * 		puz - receives the new puzzle
+ * 		rng - the random number stream to draw from
  *****************************************************************************/
-void fitness()
+void randomPuzzle(const ProblemContext &problem, Puzzle &puz, Rng &rng)
 {
-	//map for counting symbols in each row, col, subgrid
-	for (int i = 0; i < population.size(); i++)
+	puz = problem.initial_puzzle;
+
+	for (int g = 0; g < BOARD_DIM; g++)
 	{
-		// only check rows and columns since we know subgrids have no duplicates
-		population[i].evaluateFitness();
-	}
+		// randomly match the missing values to squares they are possible in
+		const FreeCells &cells = problem.free_cells[g];
+		int cell_order[BOARD_DIM];
+		int value_order[BOARD_DIM];
+		for (int i = 0; i < cells.count; i++)
+		{
+			cell_order[i] = i;
+			value_order[i] = i;
+		}
+		rng.shuffle(cell_order, cell_order + cells.count);
+		rng.shuffle(value_order, value_order + cells.count);
 
-	// sort the population based on fitness
-	sort(population.begin(), population.end());
+		char values[BOARD_DIM];
+		if (!cells.assign(cell_order, value_order, values))
+		{
+			copy(cells.values, cells.values + cells.count, values);
+			rng.shuffle(values, values + cells.count);
+		}
+
+		for (int i = 0; i < cells.count; i++)
+		{
+			puz.setValue(cells.positions[i], values[i]);
+		}
+	}
 }
 
 /******************************************************************************
- * eraseSetValue()
+ * fitness(Island&)
  *
- * This function goes through a vector of characters and when it finds the
- * target character it erases it from the vector. The resulting vector is then
- * returned.
+ * This function ranks the population. Every puzzle's fitness is already up
+ * to date, since new puzzles are evaluated when generated and breeding and
+ * mutation update the fitness of children incrementally. 
  *
- * params:
- *		   set - a vector of possible characters
- *		target - the target character to erase
+ * Fitness is a small bounded integer (at most two duplicates counts for each
+ * row and column), so the ranking is built with a counting sort over puzzle
+ * indices rather than sorting the puzzles themselves. No puzzle is moved, and
+ * the 'ranking' vector lists population indices in ascending fitness order.
  *
- * returns: a vector of characters with the target character removed
+ * params:
+ *		isl - the island to rank
  *****************************************************************************/
-vector<char> eraseSetValue (vector<char> set, char target)
+void fitness(Island &isl)
 {
-	for (int i = 0; i < set.size(); i++){
-		if (set[i] == target){
-			set.erase(set.begin()+i);
-			return set;
-		}
+	int max_fitness = 2 * isl.params->DIM * isl.params->DIM;
+	vector<int> bucket_start(max_fitness + 2, 0);
+
+	// count the puzzles with each fitness
+	for (int i = 0; i < (int)isl.population.size(); i++)
+	{
+		bucket_start[isl.population[i].fitness + 1]++;
 	}
-	return set;
-}
 
+	// turn the counts into the first ranking position for each fitness
+	for (int f = 1; f < (int)bucket_start.size(); f++)
+	{
+		bucket_start[f] += bucket_start[f - 1];
+	}
+
+	// drop each puzzle index into its fitness bucket
+	isl.ranking.resize(isl.population.size());
+	for (int i = 0; i < (int)isl.population.size(); i++)
+	{
+		isl.ranking[bucket_start[isl.population[i].fitness]++] = i;
+	}
+}
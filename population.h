@@ -10,8 +10,9 @@
 #include "globals.h"
 
 
-void fitness();
-void getInitialPop();
-vector<char> eraseSetValue (vector<char>, char);
+void initIsland(Island&, const ProblemContext&, const Params&, const Rng&);
+void fitness(Island&);
+void getInitialPop(Island&);
+void randomPuzzle(const ProblemContext&, Puzzle&, Rng&);
 
 #endif
\ No newline at end of file
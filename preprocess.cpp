@@ -1,197 +1,706 @@
  /************************************************************************
    File: preprocess.cpp
-   Authors: Katie MacMillian, Jake Davidson
-   Description: The file contains functions for pre-processing the puzzle. 
-   We fill naked and hidden singles before sending the puzzle off to the 
-   genetic algorithm.
+   Authors: Katie MacMillan, Jake Davidson
+   Description: The file contains functions for pre-processing the puzzle.
+   We fill naked and hidden singles before sending the puzzle off to the
+   genetic algorithm, using locked candidates, naked and hidden subsets and
+   X-Wings to remove possible values and expose more singles.
+
+   Singles are found by constraint propagation driven by a worklist. Placing
+   a value removes it from the possible values of the square's peers, and
+   only the squares and units (rows, columns and subgrids) touched by that
+   change are queued to be checked again, so the puzzle is never rescanned.
+   Possible values removed by the other techniques are queued the same way.
  ************************************************************************/
 #include "preprocess.h"
 
 /******************************************************************************
- * fillNakeSingles()
+ * Worklist
+ * The squares and units waiting to be checked for singles. Each square and
+ * unit is queued at most once at a time, so the stacks never overflow.
+ *****************************************************************************/
+struct Worklist
+{
+	int squares[BOARD_SQUARES]; //squares to check for a naked single
+	int square_ct; //number of squares queued
+	bool square_queued[BOARD_SQUARES]; //true while a square is queued
+	int units[BOARD_UNITS]; //units to check for hidden singles
+	int unit_ct; //number of units queued
+	bool unit_queued[BOARD_UNITS]; //true while a unit is queued
+	ProblemContext *problem; //the puzzle being preprocessed
+};
+
+static void queueSquare(Worklist&, int);
+static void queueUnits(Worklist&, int);
+static void placeSingle(Worklist&, int, char);
+static bool eliminate(Worklist&, int, int);
+static bool eliminateMask(Worklist&, int, uint32_t);
+static void propagate(Worklist&, PreprocessCounts&);
+static int checkHiddenSingles(Worklist&, int);
+static bool applyTechniques(Worklist&, PreprocessCounts&);
+static bool lockedCandidates(Worklist&, PreprocessCounts&);
+static bool lockCandidate(Worklist&, int, int, int);
+static bool nakedSubsets(Worklist&, PreprocessCounts&);
+static bool hiddenSubsets(Worklist&, PreprocessCounts&);
+static bool xWings(Worklist&, PreprocessCounts&);
+static uint32_t valuePositions(ProblemContext&, int, int);
+static int unitOf(int, int);
+static uint32_t nextCombination(uint32_t);
+
+/******************************************************************************
+ * preprocessPuzzle(ProblemContext&, int, PreprocessCounts&)
+ *
+ * This function fills in every value of a puzzle that can be
+ * found by logic alone. A naked single is a square with only one possible
+ * value, and a hidden single is a value with only one possible square in a
+ * row, column or subgrid.
  *
- * This function goes through each square of the initial puzzle and evaluates
- * the possible values. If only one value exists that could go in a given
- * square, that is the value set to the square.
+ * The possible values of every square are worked out once from the preset
+ * values. Every blank square and every unit is then queued. Checking a
+ * square or unit may place a single, which removes the value from the
+ * square's peers and queues only the peers whose possible values changed,
+ * along with their units. Filling a single can reveal new singles of either
+ * kind, so both are found from the same worklist.
  *
- * This process will happen repeatedly for all squares in the puzzle until
- * all squares have been evaluated without a single being filled in.
+ * Once no singles are left, the more expensive techniques are tried in
+ * order of cost (locked candidates, naked subsets, hidden subsets and
+ * X-Wings). These never fill a square themselves, but the possible values
+ * they remove go through the same worklist, so any single they reveal is
+ * propagated before the next technique is tried. The function returns once
+ * no technique can remove anything more.
  *
- * returns: true if at least one naked single was filled in
+ * The level (set by the --preprocess option) can limit this to singles
+ * only, or skip it entirely and only work out the possible values.
+ *
+ * params:
+ *		problem - the puzzle to fill in, changed in place
+ *		  level - 0 for no preprocessing, 1 for singles only, 2 for every
+ *				  technique
+ *		 counts - receives how often each technique was used
+ *
+ * returns: the number of singles filled in
  *****************************************************************************/
-bool fillNakedSingles()
+int preprocessPuzzle(ProblemContext &problem, int level, PreprocessCounts &counts)
 {
-	// the value returned to the calling function to indicate whether a single was filled in this function execution
-	bool found = false;
-	bool filled;
-	
+	Worklist work;
+	work.problem = &problem;
+	work.square_ct = 0;
+	work.unit_ct = 0;
+	fill(work.square_queued, work.square_queued + BOARD_SQUARES, false);
+	fill(work.unit_queued, work.unit_queued + BOARD_UNITS, false);
+
+	problem.evaluatePossibleValues();
+	if (level == 0)
+		return 0;
+
+	// check everything once to start with
+	for (int pos = BOARD_SQUARES - 1; pos >= 0; pos--)
+	{
+		if (problem[pos].getValue() == '-')
+			queueSquare(work, pos);
+	}
+	for (int u = BOARD_UNITS - 1; u >= 0; u--)
+	{
+		work.unit_queued[u] = true;
+		work.units[work.unit_ct++] = u;
+	}
+
 	do
 	{
-		filled = false;
-		initial_puzzle.evaluatePossibleValues();
-		
-		// for each square get the possible values it could be
-		for(int i = 0; i < (const_data.DIM * const_data.DIM); i++)
+		propagate(work, counts);
+	} while (level > 1 && applyTechniques(work, counts));
+
+	return counts.naked_singles + counts.hidden_singles;
+}
+
+/******************************************************************************
+ * propagate(Worklist&, PreprocessCounts&)
+ *
+ * This function drains the worklist, filling in naked singles from the
+ * queued squares and hidden singles from the queued units. Every single
+ * filled queues the squares and units it affects, so when the worklist is
+ * empty there are no singles left in the puzzle.
+ *
+ * params:
+ *		  work - the worklist to drain
+ *		counts - receives the number of singles of each kind
+ *****************************************************************************/
+static void propagate(Worklist &work, PreprocessCounts &counts)
+{
+	ProblemContext &problem = *work.problem;
+	while (work.square_ct > 0 || work.unit_ct > 0)
+	{
+		// naked singles are cheaper to confirm, so drain the squares first
+		if (work.square_ct > 0)
 		{
-			// only check "blank" values
-			if(initial_puzzle[i].getValue() == '-')
+			int pos = work.squares[--work.square_ct];
+			work.square_queued[pos] = false;
+
+			// fill in value if only one possible value exists
+			if (problem[pos].getValue() == '-' && problem[pos].getPossibleCt() == 1)
 			{
-				// fill in value if only one possible value exists
-				if (initial_puzzle[i].getPossibleCt() == 1)
-				{
-					initial_puzzle[i].setSingle();
-					filled = true;
-					found = true;
-				}
+				problem[pos].setSingle();
+				placeSingle(work, pos, problem[pos].getValue());
+				counts.naked_singles++;
 			}
 		}
-	// repeat naked single scan until a scan occurs where no changes are made
-	} while (filled);
+		else
+		{
+			int unit = work.units[--work.unit_ct];
+			work.unit_queued[unit] = false;
+			counts.hidden_singles += checkHiddenSingles(work, unit);
+		}
+	}
+}
+
+/******************************************************************************
+ * placeSingle(Worklist&, int, char)
+ *
+ * This function propagates a value which has just been set as a single. The
+ * value is removed from the possible values of each blank peer, and the
+ * units of the square itself are queued for hidden singles.
+ *
+ * params:
+ *		 work - the worklist to add to
+ *		  pos - the 1D position of the square that was filled
+ *		value - the value it was filled with
+ *****************************************************************************/
+static void placeSingle(Worklist &work, int pos, char value)
+{
+	queueUnits(work, pos);
 
-	return found;
+	for (int i = 0; i < BOARD_PEERS; i++)
+	{
+		eliminate(work, BOARD.peers[pos][i], valueIndex(value));
+	}
 }
 
 /******************************************************************************
- * fillHiddenSingles()
+ * eliminate(Worklist&, int, int)
  *
- * This function looks at each row of the initial puzzle, then each column,
- * then each subgrid. For each one it determines which values are left to be
- * filled in, and how many position options each value has. If a value only
- * has one position option, that value is set to the square in that position.
+ * This function removes a possible value from a blank square. If the value
+ * was possible, a square left with one possible value is queued as a naked
+ * single candidate, and the square's units are queued for hidden singles.
  *
- * This process of row, column and subgrid evaluation will happen repeatedly
- * until all have been examined at least once without any singles being filled
- * in.
+ * params:
+ *		work - the worklist to add to
+ *		 pos - the 1D position of the square
+ *		   v - the index of the value to remove
  *
- * returns: true if at least one hidden single was filled in
+ * returns: true if the value was possible and has been removed
  *****************************************************************************/
-bool fillHiddenSingles()
+static bool eliminate(Worklist &work, int pos, int v)
 {
-	// the value returned to the calling function to indicate whether a single was filled in this function execution
-	bool found = false;
-	bool filled;
+	square &s = (*work.problem)[pos];
+	char value = valueSymbol(v);
+	if (s.getValue() != '-' || !s.isPossibleValue(value))
+		return false;
 
-	do
+	s.togglePossible(value);
+	if (s.getPossibleCt() == 1)
 	{
-		filled = false;
-		initial_puzzle.evaluatePossibleValues();
+		queueSquare(work, pos);
+	}
+	queueUnits(work, pos);
+	return true;
+}
 
-		// for each possible value (1-9)
-		for (int v = 0; v < const_data.DIM; v++){
-			char value = const_data.VALUE_SET[v];
+/******************************************************************************
+ * eliminateMask(Worklist&, int, uint32_t)
+ *
+ * This function removes several possible values from a blank square.
+ *
+ * params:
+ *		  work - the worklist to add to
+ *		   pos - the 1D position of the square
+ *		values - mask of the value indices to remove
+ *
+ * returns: true if at least one of the values was removed
+ *****************************************************************************/
+static bool eliminateMask(Worklist &work, int pos, uint32_t values)
+{
+	bool removed = false;
+	for (uint32_t m = values; m != 0; m &= m - 1)
+	{
+		removed |= eliminate(work, pos, __builtin_ctz(m));
+	}
+	return removed;
+}
 
-			// look at each row
-			for (int r = 0; r < const_data.DIM; r++)
+/******************************************************************************
+ * checkHiddenSingles(Worklist&, int)
+ *
+ * This function fills in the hidden singles of one unit. The possible value
+ * masks of the unit's blank squares are folded together into the values
+ * possible in at least one square and those possible in at least two. The
+ * values possible in exactly one square, which are not already in the unit,
+ * are hidden singles and are set in the square that can hold them.
+ *
+ * params:
+ *		work - the worklist to add to
+ *		unit - the row, column or subgrid to check
+ *
+ * returns: the number of hidden singles filled in
+ *****************************************************************************/
+static int checkHiddenSingles(Worklist &work, int unit)
+{
+	ProblemContext &problem = *work.problem;
+	const int *cells = BOARD.units[unit];
+	square::mask_type once = 0;
+	square::mask_type twice = 0;
+	square::mask_type placed = 0;
+
+	for (int i = 0; i < BOARD_DIM; i++)
+	{
+		square &s = problem[cells[i]];
+		if (s.getValue() == '-')
+		{
+			twice |= once & s.getPossible();
+			once |= s.getPossible();
+		}
+		else
+		{
+			placed |= (square::mask_type)(1u << valueIndex(s.getValue()));
+		}
+	}
+
+	int filled = 0;
+	for (square::mask_type m = once & ~twice & ~placed; m != 0; m &= m - 1)
+	{
+		int v = __builtin_ctz(m);
+		char value = valueSymbol(v);
+
+		// find the only square that can hold the value
+		for (int i = 0; i < BOARD_DIM; i++)
+		{
+			square &s = problem[cells[i]];
+			if (s.getValue() == '-' && s.isPossibleValue(value))
 			{
-				// get the position the value can go in in the row
-				int pos = findSinglePosition(initial_puzzle.getRow(r), value);
+				s.setSingle(value);
+				placeSingle(work, cells[i], value);
+				filled++;
+				break;
+			}
+		}
+	}
+	return filled;
+}
 
-				if ((pos != -1) && (pos != -2))
-				{
-					// find position of square in linear puzzle vector
-					pos += (r * const_data.DIM);
-					initial_puzzle[pos].setSingle(value);
-					filled = true;
-					found = true;
-				}
+/******************************************************************************
+ * queueSquare(Worklist&, int)
+ *
+ * Queue a square to be checked for a naked single, unless it is already
+ * waiting.
+ *
+ * params:
+ *		work - the worklist to add to
+ *		 pos - the 1D position of the square
+ *****************************************************************************/
+static void queueSquare(Worklist &work, int pos)
+{
+	if (!work.square_queued[pos])
+	{
+		work.square_queued[pos] = true;
+		work.squares[work.square_ct++] = pos;
+	}
+}
+
+/******************************************************************************
+ * queueUnits(Worklist&, int)
+ *
+ * Queue the row, column and subgrid of a square to be checked for hidden
+ * singles, skipping any that are already waiting.
+ *
+ * params:
+ *		work - the worklist to add to
+ *		 pos - the 1D position of the square
+ *****************************************************************************/
+static void queueUnits(Worklist &work, int pos)
+{
+	int units[3] = {ROW_UNIT + BOARD.row[pos], COL_UNIT + BOARD.col[pos], BOX_UNIT + BOARD.box[pos]};
+	for (int i = 0; i < 3; i++)
+	{
+		if (!work.unit_queued[units[i]])
+		{
+			work.unit_queued[units[i]] = true;
+			work.units[work.unit_ct++] = units[i];
+		}
+	}
+}
+
+/******************************************************************************
+ * applyTechniques(Worklist&, PreprocessCounts&)
+ *
+ * This function tries the techniques beyond singles, cheapest first, and
+ * stops at the first one which removes a possible value. The caller then
+ * propagates any singles revealed before anything more expensive is tried.
+ *
+ * params:
+ *		  work - the worklist to add to
+ *		counts - receives how often each technique was used
+ *
+ * returns: true if any possible value was removed
+ *****************************************************************************/
+static bool applyTechniques(Worklist &work, PreprocessCounts &counts)
+{
+	return lockedCandidates(work, counts) || nakedSubsets(work, counts) ||
+		   hiddenSubsets(work, counts) || xWings(work, counts);
+}
+
+/******************************************************************************
+ * lockedCandidates(Worklist&, PreprocessCounts&)
+ *
+ * This function looks for values locked into the overlap of two units. If
+ * every square of a subgrid which can hold a value is in the same row or
+ * column (a pointing pair or triple), the value must go in that part of the
+ * row or column, so it is removed from the rest of it. In the same way, if
+ * every square of a row or column which can hold a value is in the same
+ * subgrid (box/line reduction), the value is removed from the rest of the
+ * subgrid.
+ *
+ * params:
+ *		  work - the worklist to add to
+ *		counts - receives the number of pointing and box/line patterns used
+ *
+ * returns: true if any possible value was removed
+ *****************************************************************************/
+static bool lockedCandidates(Worklist &work, PreprocessCounts &counts)
+{
+	bool removed = false;
+	for (int v = 0; v < BOARD_DIM; v++)
+	{
+		// subgrids pointing into a row or column
+		for (int g = 0; g < BOARD_DIM; g++)
+		{
+			if (lockCandidate(work, BOX_UNIT + g, v, ROW_UNIT) || lockCandidate(work, BOX_UNIT + g, v, COL_UNIT))
+			{
+				counts.pointing++;
+				removed = true;
+			}
+		}
+		// rows and columns locked into a subgrid
+		for (int line = ROW_UNIT; line < BOX_UNIT; line++)
+		{
+			if (lockCandidate(work, line, v, BOX_UNIT))
+			{
+				counts.box_line++;
+				removed = true;
+			}
+		}
+	}
+	return removed;
+}
+
+/******************************************************************************
+ * lockCandidate(Worklist&, int, int, int)
+ *
+ * This function checks whether the squares of a unit which can hold a value
+ * all lie in one unit of another kind. If they do, the value is removed from
+ * the squares of that other unit which are outside the first.
+ *
+ * params:
+ *		work - the worklist to add to
+ *		unit - the unit the value is locked in
+ *		   v - the index of the value
+ *		kind - the first unit of the kind to look for (ROW_UNIT, COL_UNIT
+ *			   or BOX_UNIT)
+ *
+ * returns: true if any possible value was removed
+ *****************************************************************************/
+static bool lockCandidate(Worklist &work, int unit, int v, int kind)
+{
+	uint32_t where = valuePositions(*work.problem, unit, v);
+	// a single position is a hidden single, which propagation already handles
+	if (__builtin_popcount(where) < 2)
+		return false;
+
+	const int *cells = BOARD.units[unit];
+	int target = unitOf(cells[__builtin_ctz(where)], kind);
+	for (uint32_t m = where; m != 0; m &= m - 1)
+	{
+		if (unitOf(cells[__builtin_ctz(m)], kind) != target)
+			return false;
+	}
+
+	int unit_kind = (unit / BOARD_DIM) * BOARD_DIM;
+	bool removed = false;
+	for (int i = 0; i < BOARD_DIM; i++)
+	{
+		int pos = BOARD.units[target][i];
+		if (unitOf(pos, unit_kind) != unit)
+		{
+			removed |= eliminate(work, pos, v);
+		}
+	}
+	return removed;
+}
+
+/******************************************************************************
+ * nakedSubsets(Worklist&, PreprocessCounts&)
+ *
+ * This function looks for naked subsets. If n squares of a unit can only
+ * hold the same n values between them (a naked pair or triple), those values
+ * must go in those squares, so they are removed from the rest of the unit.
+ * Only squares with 2 to MAX_SUBSET possible values can be in a subset, and
+ * every combination of them is checked.
+ *
+ * params:
+ *		  work - the worklist to add to
+ *		counts - receives the number of naked subsets used
+ *
+ * returns: true if any possible value was removed
+ *****************************************************************************/
+static bool nakedSubsets(Worklist &work, PreprocessCounts &counts)
+{
+	ProblemContext &problem = *work.problem;
+	bool removed = false;
+	for (int unit = 0; unit < BOARD_UNITS; unit++)
+	{
+		const int *cells = BOARD.units[unit];
+
+		// the squares which could be in a subset, and their possible values
+		int items[BOARD_DIM];
+		uint32_t masks[BOARD_DIM];
+		int n = 0;
+		for (int i = 0; i < BOARD_DIM; i++)
+		{
+			square &s = problem[cells[i]];
+			int ct = s.getPossibleCt();
+			if (s.getValue() == '-' && ct >= 2 && ct <= MAX_SUBSET)
+			{
+				items[n] = i;
+				masks[n++] = s.getPossible();
 			}
+		}
 
-			// look at each column
-			for (int c = 0; c < const_data.DIM; c++)
+		for (int k = 2; k <= MAX_SUBSET; k++)
+		{
+			for (uint32_t c = (1u << k) - 1; c < (1u << n); c = nextCombination(c))
 			{
-				// get the position the value can go in in the column
-				int pos = findSinglePosition(initial_puzzle.getCol(c), value);
+				uint32_t values = 0;
+				uint32_t chosen = 0;
+				for (uint32_t m = c; m != 0; m &= m - 1)
+				{
+					values |= masks[__builtin_ctz(m)];
+					chosen |= 1u << items[__builtin_ctz(m)];
+				}
+				if (__builtin_popcount(values) != k)
+					continue;
 
-				if ((pos != -1) && (pos != -2))
+				// the subset's values can't go anywhere else in the unit
+				bool hit = false;
+				for (int i = 0; i < BOARD_DIM; i++)
+				{
+					if (!((chosen >> i) & 1))
+						hit |= eliminateMask(work, cells[i], values);
+				}
+				if (hit)
 				{
-					// find position of square in linear puzzle vector
-					pos = (pos * const_data.DIM) + c;
-					initial_puzzle[pos].setSingle(value);
-					filled = true;
-					found = true;
+					counts.naked_subsets++;
+					removed = true;
 				}
 			}
+		}
+	}
+	return removed;
+}
 
-			// look at each subgrid
-			for (int r = 0; r < const_data.DIM; r += const_data.SUBDIM)
+/******************************************************************************
+ * hiddenSubsets(Worklist&, PreprocessCounts&)
+ *
+ * This function looks for hidden subsets. If n values of a unit can only go
+ * in the same n squares between them (a hidden pair or triple), those
+ * squares must hold those values, so every other value is removed from
+ * them. Only values with 2 to MAX_SUBSET possible squares can be in a
+ * subset, and every combination of them is checked.
+ *
+ * params:
+ *		  work - the worklist to add to
+ *		counts - receives the number of hidden subsets used
+ *
+ * returns: true if any possible value was removed
+ *****************************************************************************/
+static bool hiddenSubsets(Worklist &work, PreprocessCounts &counts)
+{
+	ProblemContext &problem = *work.problem;
+	bool removed = false;
+	for (int unit = 0; unit < BOARD_UNITS; unit++)
+	{
+		const int *cells = BOARD.units[unit];
+
+		// the values which could be in a subset, and their possible squares
+		int items[BOARD_DIM];
+		uint32_t masks[BOARD_DIM];
+		int n = 0;
+		for (int v = 0; v < BOARD_DIM; v++)
+		{
+			uint32_t where = valuePositions(problem, unit, v);
+			int ct = __builtin_popcount(where);
+			if (ct >= 2 && ct <= MAX_SUBSET)
+			{
+				items[n] = v;
+				masks[n++] = where;
+			}
+		}
+
+		for (int k = 2; k <= MAX_SUBSET; k++)
+		{
+			for (uint32_t c = (1u << k) - 1; c < (1u << n); c = nextCombination(c))
 			{
-				for (int c = 0; c < const_data.DIM; c += const_data.SUBDIM)
+				uint32_t where = 0;
+				uint32_t values = 0;
+				for (uint32_t m = c; m != 0; m &= m - 1)
 				{
-					// get the position the value can go in in the subgrid
-					int pos = findSinglePosition(initial_puzzle.getSub(r, c), value);
+					where |= masks[__builtin_ctz(m)];
+					values |= 1u << items[__builtin_ctz(m)];
+				}
+				if (__builtin_popcount(where) != k)
+					continue;
 
-					if ((pos != -1) && (pos != -2))
-					{
-						// find position of square in linear puzzle vector
-						pos = (((pos / const_data.SUBDIM) + r) *const_data. DIM) + (pos % const_data.SUBDIM) + c;
-						initial_puzzle[pos].setSingle(value);
-						filled = true;
-						found = true;
-					}
+				// the subset's squares can't hold any other value
+				bool hit = false;
+				for (uint32_t m = where; m != 0; m &= m - 1)
+				{
+					int pos = cells[__builtin_ctz(m)];
+					hit |= eliminateMask(work, pos, problem[pos].getPossible() & ~values);
+				}
+				if (hit)
+				{
+					counts.hidden_subsets++;
+					removed = true;
 				}
 			}
 		}
-	// repeat hidden single scan until a scan occurs where no changes are made
-	} while (filled);
-
-	return found;
+	}
+	return removed;
 }
 
 /******************************************************************************
- * findSinglePosition(vector<square>, char)
+ * xWings(Worklist&, PreprocessCounts&)
+ *
+ * This function looks for X-Wings. If a value can only go in the same two
+ * columns of two different rows, it must take one of those columns in each
+ * row, so it is removed from the rest of both columns. The same is done
+ * with the rows and columns swapped.
  *
- * This function evaluates a vector of squares to determine how many positions
- * within the vector a given character can go. Each square within the vector
- * is checked to see if the character is a possible value of the square. If
- * so, the found flag is set. If a position is found where the value can go
- * when the found flag is already set, the position for the value is set to
- * -2, which breaks the check loop, and -2 is returned. This will indicate
- * that there are multiple positions the value can go in.
+ * Since the squares of a row are listed in column order (and those of a
+ * column in row order), a value's positions within one line are also the
+ * lines of the other kind that it crosses.
  *
  * params:
- *		squares - a vector of squares representing either a row, column, or
- *				  subgrid within a puzzle
- *		  value - a specific character value to count positions for
+ *		  work - the worklist to add to
+ *		counts - receives the number of X-Wings used
  *
- * returns: -2 if the character value has more than one possible position
- *			the only position a character value can go in
+ * returns: true if any possible value was removed
  *****************************************************************************/
-int findSinglePosition(vector<square> squares, char value)
+static bool xWings(Worklist &work, PreprocessCounts &counts)
 {
-	// track the first square index it can be in
-	int pos = -1;
-	// track whether the value can go in a previous square
-	bool found = false;
-	// index into squares vector
-	int s = 0;
-
-	do{
-	// if the square does not have a number
-	if(squares[s].getValue() == '-')
+	bool removed = false;
+	for (int base = ROW_UNIT; base <= COL_UNIT; base += BOARD_DIM)
 	{
-		// check if the value is a possible solution for the square
-		if(squares[s].isPossibleValue(value))
+		int cover = (base == ROW_UNIT) ? COL_UNIT : ROW_UNIT;
+		for (int v = 0; v < BOARD_DIM; v++)
 		{
-			// check if the value is already valid elsewhere in the squares
-			if(found)
+			uint32_t where[BOARD_DIM];
+			for (int a = 0; a < BOARD_DIM; a++)
 			{
-				// if so, break
-				pos = -2;
+				where[a] = valuePositions(*work.problem, base + a, v);
 			}
-			else
+
+			for (int a = 0; a < BOARD_DIM; a++)
 			{
-				// else set pos to the square indedx and found flag to true
-				found = true;
-				pos = s;
+				if (__builtin_popcount(where[a]) != 2)
+					continue;
+				for (int b = a + 1; b < BOARD_DIM; b++)
+				{
+					if (where[b] != where[a])
+						continue;
+
+					// clear the value from the crossing lines, except in lines a and b
+					bool hit = false;
+					for (uint32_t m = where[a]; m != 0; m &= m - 1)
+					{
+						const int *cells = BOARD.units[cover + __builtin_ctz(m)];
+						for (int i = 0; i < BOARD_DIM; i++)
+						{
+							if (i != a && i != b)
+								hit |= eliminate(work, cells[i], v);
+						}
+					}
+					if (hit)
+					{
+						counts.x_wings++;
+						removed = true;
+					}
+				}
 			}
 		}
-		// if square holds value we're checking, cause loop to stop
-		} else if (squares[s].getValue() == value){
-			pos = -2;
-		}
+	}
+	return removed;
+}
 
-		s++;
-	} while ((pos!= -2) && (s < const_data.DIM));
+/******************************************************************************
+ * valuePositions(ProblemContext&, int, int)
+ *
+ * This function finds the blank squares of a unit which can hold a value.
+ *
+ * params:
+ *		problem - the puzzle being preprocessed
+ *		   unit - the row, column or subgrid to look in
+ *			  v - the index of the value
+ *
+ * returns: a mask with bit i set if the i'th square of the unit can hold the
+ *			value
+ *****************************************************************************/
+static uint32_t valuePositions(ProblemContext &problem, int unit, int v)
+{
+	const int *cells = BOARD.units[unit];
+	uint32_t where = 0;
+	for (int i = 0; i < BOARD_DIM; i++)
+	{
+		square &s = problem[cells[i]];
+		if (s.getValue() == '-' && ((s.getPossible() >> v) & 1))
+			where |= 1u << i;
+	}
+	return where;
+}
+
+/******************************************************************************
+ * unitOf(int, int)
+ *
+ * This function finds the unit of a given kind which holds a square.
+ *
+ * params:
+ *		 pos - the 1D position of the square
+ *		kind - the first unit of the kind (ROW_UNIT, COL_UNIT or BOX_UNIT)
+ *
+ * returns: the unit of that kind which holds the square
+ *****************************************************************************/
+static int unitOf(int pos, int kind)
+{
+	if (kind == ROW_UNIT)
+		return ROW_UNIT + BOARD.row[pos];
+	if (kind == COL_UNIT)
+		return COL_UNIT + BOARD.col[pos];
+	return BOX_UNIT + BOARD.box[pos];
+}
 
-	return pos;
-}
\ No newline at end of file
+/******************************************************************************
+ * nextCombination(uint32_t)
+ *
+ * This function steps to the next combination of the same number of items,
+ * with each combination held as a mask of chosen items. Starting from the
+ * lowest k bits set, it visits every combination of k items in increasing
+ * order.
+ *
+ * params:
+ *		c - the current combination
+ *
+ * returns: the next larger mask with the same number of bits set
+ *****************************************************************************/
+static uint32_t nextCombination(uint32_t c)
+{
+	uint32_t low = c & -c;
+	uint32_t ripple = c + low;
+	return ripple | (((c ^ ripple) >> 2) / low);
+}
@@ -8,9 +8,26 @@
 
 #include "globals.h"
 
+// largest naked or hidden subset looked for (3 finds pairs and triples)
+const int MAX_SUBSET = 3;
 
-bool fillNakedSingles();
-bool fillHiddenSingles();
-int findSinglePosition(vector<square>, char);
+/******************************************************************************
+ * PreprocessCounts
+ * How many times each preprocessing technique was used. Singles count the
+ * values filled in, the other techniques count each pattern found which
+ * removed at least one possible value.
+ *****************************************************************************/
+struct PreprocessCounts
+{
+	int naked_singles = 0; //squares with only one possible value
+	int hidden_singles = 0; //values with only one possible square in a unit
+	int pointing = 0; //subgrid values locked into one row or column
+	int box_line = 0; //row or column values locked into one subgrid
+	int naked_subsets = 0; //squares sharing the same few possible values
+	int hidden_subsets = 0; //values sharing the same few possible squares
+	int x_wings = 0; //values locked into the same two positions of two lines
+};
 
-#endif
\ No newline at end of file
+int preprocessPuzzle(ProblemContext&, int, PreprocessCounts&);
+
+#endif
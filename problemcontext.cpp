@@ -0,0 +1,343 @@
+ /************************************************************************
+   File: problemcontext.cpp
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Function definitions for the problem context class
+ ************************************************************************/
+#include "problemcontext.h"
+
+/***************
+ * Constructors
+ ***************/
+
+/******************************************************************
+ * ProblemContext()
+ * Constructor for a new problem context with no squares added.
+ *****************************************************************/
+ProblemContext::ProblemContext()
+{
+	_count = 0; //no squares added yet
+	subgrid_presets.fill(0);
+}
+
+/***************
+ * Operators
+ ***************/
+
+/******************************************************************
+ * operator [] (int i)
+ * overloaded [] operator for access to the initial puzzle squares
+ *
+ * params:
+ *			i - index of square to access
+ * returns: reference to the square at index i
+ *****************************************************************/
+square & ProblemContext::operator [] (int i)
+{
+	return _squares[i];
+}
+
+/***************
+ * Functions
+ ***************/
+
+/******************************************************************
+ * addSquare(square s)
+ * Add a new square to the end of the initial puzzle.
+ *
+ * params:
+ *			s - square to add
+ *****************************************************************/
+void ProblemContext::addSquare(square s)
+{
+	// ignore squares beyond the end of the puzzle
+	if (_count < BOARD_SQUARES)
+	{
+		_squares[_count++] = s;
+	}
+}
+
+/******************************************************************
+ * size()
+ * Returns the number of squares added to the initial puzzle
+ *
+ * returns: the number of squares as int
+ *****************************************************************/
+int ProblemContext::size()
+{
+	return _count;
+}
+
+/******************************************************************
+ * isPreset(int pos)
+ * Check if a square is preset, either in the initial puzzle config
+ * or as a single filled by preprocessing.
+ *
+ * params:
+ *			pos - the 1D position of the square
+ * returns: true if the square's value is fixed
+ *****************************************************************/
+bool ProblemContext::isPreset(int pos)
+{
+	return _squares[pos].preset;
+}
+
+/******************************************************************
+ * getRow(int r)
+ * returns a view of a row of the initial puzzle
+ *
+ * params:
+ *			r - row to return
+ * returns: a view of the squares in row r
+ *****************************************************************/
+SquareView ProblemContext::getRow(int r)
+{
+	//one run of dim squares starting at the 1D start pos of the row
+	return SquareView(_squares.data(), r*BOARD_DIM, BOARD_DIM, BOARD_DIM, BOARD_DIM);
+}
+
+/******************************************************************
+ * getCol(int c)
+ * returns a view of a col of the initial puzzle
+ *
+ * params:
+ *			c - col to return
+ * returns: a view of the squares in col c
+ *****************************************************************/
+SquareView ProblemContext::getCol(int c)
+{
+	//dim runs of one square, each a full row apart
+	return SquareView(_squares.data(), c, 1, BOARD_DIM, BOARD_DIM);
+}
+
+/******************************************************************
+ * getSub(int r, int c)
+ * returns a view of a subgrid from the initial puzzle
+ *
+ * params:
+ *			r - row of subgrid
+ *			c - col of subgrid
+ * returns: a view of the squares in the specified subgrid
+ *****************************************************************/
+SquareView ProblemContext::getSub(int r, int c)
+{
+	//get top left square of the subgrid from r and c
+	int row = r - r%BOARD_SUBDIM;
+	int col = c - c%BOARD_SUBDIM;
+	//sub_dim runs of sub_dim squares, each a full row apart
+	return SquareView(_squares.data(), (row * BOARD_DIM) + col, BOARD_SUBDIM, BOARD_DIM, BOARD_DIM);
+}
+
+/******************************************************************
+ * evaluatePossibleValues()
+ * eliminate all possible values from each square
+ *****************************************************************/
+void ProblemContext::evaluatePossibleValues()
+{
+	for(int pos = 0; pos < BOARD_SQUARES; pos++)
+	{
+		eliminateValues(_squares[pos], pos);
+	}
+}
+
+/******************************************************************
+ * eliminateValues(square &s, int pos)
+ * Eliminate possible square values for a particular square.
+ * We can eliminate possible square values if that square's symbol
+ * exists in any of its peers (its row, col, and subgrid)
+ *
+ * params:
+ *			s - the square to eliminate values from
+ *			pos - the 1D position of the square in the puzzle
+ *****************************************************************/
+void ProblemContext::eliminateValues(square &s, int pos)
+{
+	for (int i = 0; i < BOARD_PEERS; i++)
+	{
+		char value = _squares[BOARD.peers[pos][i]].getValue();
+		if (value != '-')
+		{
+			s.togglePossible(value);
+		}
+	}
+}
+
+/******************************************************************
+ * evaluatePresets()
+ * Count the preset values in each subgrid once singles have been
+ * filled, and record each subgrid's free squares along with the
+ * values missing from it. None of this changes during a run, so the
+ * population generation, breeding and mutation all work from these
+ * lists rather than searching each puzzle for non-preset squares.
+ *
+ * The possible values of each free square are kept so that puzzles
+ * only ever hold values preprocessing has not ruled out. If the
+ * possible values leave no way to place every missing value (only
+ * possible for a puzzle with no solution) the subgrid's free squares
+ * are allowed every missing value instead. Pairs of free squares
+ * sharing at least two possible values are listed as swap pairs, and
+ * subgrids with at least one swap pair are listed as mutable.
+ *
+ * The filled in puzzle is kept, with its fitness evaluated, as the
+ * starting point for every member of the population.
+ *****************************************************************/
+void ProblemContext::evaluatePresets()
+{
+	mutable_subgrids.clear();
+
+	for (int g = 0; g < BOARD_DIM; g++)
+	{
+		const int *grid = BOARD.units[BOX_UNIT + g];
+		bool present[BOARD_DIM] = {false};
+		FreeCells &cells = free_cells[g];
+
+		subgrid_presets[g] = 0;
+		cells.count = 0;
+		for (int i = 0; i < BOARD_DIM; i++)
+		{
+			square &s = _squares[grid[i]];
+			if (s.preset)
+			{
+				subgrid_presets[g]++;
+				present[valueIndex(s.getValue())] = true;
+			}
+			else
+			{
+				cells.positions[cells.count++] = grid[i];
+			}
+		}
+
+		// every value not already in the subgrid goes into its free squares
+		int v = 0;
+		uint32_t missing = 0;
+		for (int i = 0; i < BOARD_DIM; i++)
+		{
+			if (!present[i])
+			{
+				cells.values[v++] = valueSymbol(i);
+				missing |= 1u << i;
+			}
+		}
+
+		// keep the possible values of each free square
+		int order[BOARD_DIM];
+		for (int i = 0; i < cells.count; i++)
+		{
+			cells.possible[i] = _squares[cells.positions[i]].getPossible() & missing;
+			order[i] = i;
+		}
+		char assigned[BOARD_DIM];
+		if (!cells.assign(order, order, assigned))
+		{
+			fill(cells.possible, cells.possible + cells.count, missing);
+		}
+
+		// list the pairs of free squares that could hold each other's values
+		cells.pair_count = 0;
+		for (int i = 0; i < cells.count; i++)
+		{
+			for (int j = i + 1; j < cells.count; j++)
+			{
+				if (__builtin_popcount(cells.possible[i] & cells.possible[j]) >= 2)
+				{
+					cells.pairs[cells.pair_count++] = {(uint8_t)i, (uint8_t)j};
+				}
+			}
+		}
+
+		if (cells.pair_count > 0)
+		{
+			mutable_subgrids.push_back(g);
+		}
+	}
+
+	initial_puzzle = makePuzzle();
+	initial_puzzle.evaluateFitness();
+}
+
+/******************************************************************
+ * makePuzzle()
+ * Copy the current square values into a new puzzle, which can then
+ * be used as a member of the population.
+ *
+ * returns: a puzzle holding the initial puzzle's values
+ *****************************************************************/
+Puzzle ProblemContext::makePuzzle()
+{
+	Puzzle puz;
+	for (int pos = 0; pos < _count; pos++)
+	{
+		puz.setValue(pos, _squares[pos].getValue());
+	}
+	return puz;
+}
+
+/***************
+ * Free cells
+ ***************/
+
+/******************************************************************
+ * augment(const FreeCells&, int, const int*, int*, bool*)
+ * Find a missing value for a free square by the augmenting path
+ * method, moving values already given to other free squares along
+ * if that frees up a value this square can hold. Missing values are
+ * tried in the order given.
+ *
+ * params:
+ *			cells - the free squares and missing values of a subgrid
+ *			 cell - index of the free square to find a value for
+ *	   value_order - order to try the missing values in
+ *			owner - free square given each missing value, or -1
+ *		  visited - missing values already tried on this path
+ * returns: true if the free square was given a value
+ *****************************************************************/
+static bool augment(const FreeCells &cells, int cell, const int *value_order, int *owner, bool *visited)
+{
+	for (int t = 0; t < cells.count; t++)
+	{
+		int v = value_order[t];
+		if (visited[v] || !cells.allows(cell, cells.values[v]))
+			continue;
+
+		visited[v] = true;
+		if (owner[v] == -1 || augment(cells, owner[v], value_order, owner, visited))
+		{
+			owner[v] = cell;
+			return true;
+		}
+	}
+	return false;
+}
+
+/******************************************************************
+ * assign(const int*, const int*, char*)
+ * Give every free square of the subgrid a different missing value
+ * that is possible for it. This is a bipartite matching of free
+ * squares to missing values, so a value is only refused to a square
+ * when no rearrangement of the values already given makes room for
+ * it. Shuffling the two orders first gives a random assignment.
+ *
+ * params:
+ *		cell_order - order to give the free squares values in
+ *	   value_order - order to try the missing values in
+ *		  assigned - receives the value of each free square
+ * returns: true if every free square got a possible value, false if
+ *			the possible values leave no way to do so
+ *****************************************************************/
+bool FreeCells::assign(const int *cell_order, const int *value_order, char *assigned) const
+{
+	int owner[BOARD_DIM];
+	fill(owner, owner + count, -1);
+
+	for (int i = 0; i < count; i++)
+	{
+		bool visited[BOARD_DIM] = {false};
+		if (!augment(*this, cell_order[i], value_order, owner, visited))
+			return false;
+	}
+
+	for (int v = 0; v < count; v++)
+	{
+		assigned[owner[v]] = values[v];
+	}
+	return true;
+}
@@ -0,0 +1,95 @@
+ /************************************************************************
+   File: problemcontext.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Header file for the problem context class. The problem
+   context holds everything about the puzzle being solved that is the same
+   for every member of the population: the squares of the initial puzzle
+   (with their preset flags and possible values), the number of preset
+   values in each subgrid and the free squares of each subgrid. Keeping this in one shared, read only object means the
+   puzzles in the population only need to carry their own values.
+
+   Usage: Fill the context one square at a time with addSquare(), then use
+   the row, column and subgrid views and evaluatePossibleValues() to fill
+   in singles. Once preprocessing is done, call evaluatePresets() to find
+   the preset counts, the free squares and the initial puzzle every member
+   of the population starts from. After that the context is only read, so
+   one context can be shared by every thread solving the same puzzle, and
+   each puzzle being solved has a context of its own.
+ ************************************************************************/
+#ifndef __PROBLEM_CONTEXT_H_
+#define __PROBLEM_CONTEXT_H_
+
+#include <array>
+#include <vector>
+#include "square.h"
+#include "squareview.h"
+#include "puzzle.h"
+#include "boardtables.h"
+
+// most pairs of free squares a subgrid can have
+const int MAX_SWAP_PAIRS = BOARD_DIM * (BOARD_DIM - 1) / 2;
+
+/******************************************************************************
+ * SwapPair
+ * Two free squares of a subgrid, given as indices into its free square list.
+ *****************************************************************************/
+struct SwapPair
+{
+	uint8_t first;
+	uint8_t second;
+};
+
+/******************************************************************************
+ * FreeCells
+ * The squares of one subgrid which are still blank in the initial puzzle once
+ * singles have been filled, along with the values missing from the subgrid.
+ * These are the only squares the genetic algorithm ever changes, so they are
+ * found once and shared by every puzzle in the population.
+ *
+ * Each free square also keeps the values preprocessing left possible for it,
+ * and the pairs of free squares sharing at least two possible values are
+ * listed, since only those pairs can ever swap two values legally.
+ *****************************************************************************/
+struct FreeCells
+{
+	int count; //number of free squares (and missing values) in the subgrid
+	int positions[BOARD_DIM]; //1D positions of the free squares
+	char values[BOARD_DIM]; //values not yet present in the subgrid
+	uint32_t possible[BOARD_DIM]; //possible values of each free square, bit i for value index i
+	int pair_count; //number of pairs which can swap legally
+	SwapPair pairs[MAX_SWAP_PAIRS]; //pairs of free squares sharing two or more possible values
+
+	bool allows(int i, char value) const { return (possible[i] >> valueIndex(value)) & 1; }
+	bool assign(const int*, const int*, char*) const; //match the missing values to the free squares
+};
+
+class ProblemContext
+{
+	private:
+		std::array<square, BOARD_SQUARES> _squares; //the squares of the initial puzzle, stored in row major format
+		int _count; //number of squares filled in so far
+		void eliminateValues(square&, int); //eliminate a square's values that it cannot be
+	public:
+		std::array<int, BOARD_DIM> subgrid_presets; // number of preset values in each subgrid
+		std::array<FreeCells, BOARD_DIM> free_cells; //free squares of each subgrid
+		std::vector<int> mutable_subgrids; //subgrids with at least one legal swap pair
+		Puzzle initial_puzzle; //the puzzle in it's init state once singles are filled
+
+		//constructors
+		ProblemContext(); //constructor for an empty problem
+		//functions
+		void addSquare(square); //add a square to the back of the puzzle
+		int size(); //get the number of squares added
+		bool isPreset(int); //check if a square is preset
+		SquareView getRow(int); //get a view of a specific row of the puzzle
+		SquareView getCol(int); //get a view of a specific col of the puzzle
+		SquareView getSub(int, int); //get a view of a specific subgrid of the puzzle
+		void evaluatePossibleValues(); //eliminate possible values for all squares in puzzle
+		void evaluatePresets(); //count presets and find the free squares of each subgrid
+		Puzzle makePuzzle(); //copy the square values into a puzzle
+
+		//overloaded operators
+		square & operator [] (int); //access a square with []
+};
+
+#endif
@@ -1,74 +1,34 @@
- /************************************************************************
+/************************************************************************
    File: puzzle.cpp
    Authors: Katie MacMillian, Jake Davidson
    Description: Function definitions for the puzzle class
  ************************************************************************/
 #include "puzzle.h"
+#include <type_traits>
+
+// copying individuals around the population must stay a flat copy
+static_assert(std::is_trivially_copyable<Puzzle>::value, "Puzzle must be trivially copyable");
 
 /***************
  * Constructors
  ***************/
 
 /******************************************************************
- * Puzzle(int dim)
- * Constructor for new puzzle object. Takes dimension of puzzle.
- *
- * params:
- *			dim - dimension of puzzle (ex, 9x9 is dim = 9)
+ * Puzzle()
+ * Constructor for new puzzle object. The dimension of the puzzle is
+ * fixed by the board order of the build. All squares start out blank.
  *****************************************************************/
-Puzzle::Puzzle(int dim)
+Puzzle::Puzzle()
 {
-	_dim = dim;
-	_sub_dim = sqrt(dim); //subgrid dimensions
+	_values.fill('-'); //every square starts blank
+	_tallied = false; //nothing tallied until fitness is evaluated
 	fitness = 0; //start with 0 fitness
 }
 
-/******************************************************************
- * Puzzle(const Puzzle& p)
- * Copy constructor for making copy of other puzzle object
- *
- * params:
- *			p - puzzle to create copy of
- *****************************************************************/
-Puzzle::Puzzle(const Puzzle& p){
-	_dim = p._dim;
-	_squares = p._squares;
-	_sub_dim = p._sub_dim;
-	fitness = p.fitness;
-	subgrid_presets = p.subgrid_presets;
-}
-
 /***************
  * Operators
  ***************/
 
-/******************************************************************
- * operator [] (int i) const
- * overloaded [] access oparator for ease of access to puzzle squares
- *
- * params:
- *			i - index of square to access
- * returns: square at index i in puzzle
- *****************************************************************/
-square Puzzle::operator [] (int i) const
-{
-	return _squares.at(i);
-}
-
-/******************************************************************
- * operator [] (int i)
- * overloaded [] operator for assignment. This allows you to assign
- * a square position in the puzzle class as you would a normal vector.
- *
- * params:
- *			i - index of square to access
- * returns: reference to location in squares vector for assignment
- *****************************************************************/
-square & Puzzle::operator [] (int i)
-{
-	return _squares.at(i);
-}
-
 /******************************************************************
  * operator < (const Puzzle& puz) const
  * overloaded < operator for use in sorting puzzles by fitness. The 
@@ -87,18 +47,6 @@ bool Puzzle::operator < (const Puzzle& puz) const
  * Functions
  ***************/
 
-/******************************************************************
- * addSquare(square s)
- * Add a new square to the end of the squares vector.
- *
- * params:
- *			s - square to add
- *****************************************************************/
-void Puzzle::addSquare(square s)
-{
-	_squares.push_back(s);
-}
-
 /******************************************************************
  * size()
  * Returns the number of squares in the puzzle
@@ -107,150 +55,45 @@ void Puzzle::addSquare(square s)
  *****************************************************************/
 int Puzzle::size()
 {
-	return _squares.size();
+	return BOARD_SQUARES;
 }
 
 /******************************************************************
- * setRow(int r, vector<square> s)
- * overwrites a row in the puzzle with a new one
+ * getDim()
+ * Returns the dimension of one side of the puzzle
  *
- * params:
- *			r - which row to set
- *			s - vector of squares to replace current row with
+ * returns: the dimension of the puzzle as int
  *****************************************************************/
-void Puzzle::setRow(int r, vector<square> s){
-	//ensure the puzzle is large enough
-	if(_squares.size() != (_dim*_dim)){
-		_squares.resize(_dim*_dim);
-	}
-	//get index into row (stored in row major 1D form)
-	int pos = r*_dim;
-	//copy values into row
-	for( int i = 0; i < s.size(); i++){
-		_squares[pos+i] = s[i];
-	}
-}
-
-/******************************************************************
- * setCol(int c, vector<square> s)
- * overwrites a column in the puzzle with a new one
- *
- * params:
- *			c - which column to set
- *			s - vector of squares to replace current column with
- *****************************************************************/
-void Puzzle::setCol(int c, vector<square> s){
-	//ensure puzzle is large enough
-	if(_squares.size() != (_dim*_dim)){
-		_squares.resize(_dim*_dim);
-	}
-	//write into column
-	for( int i = 0; i < _dim; i++){
-		int pos = (i*_dim) + c; //this gets row index
-		_squares[pos] = s[i];
-	}
-}
-/******************************************************************
- * setSub(int r, int c, vector<square> s)
- * overwrites a subgrid in the puzzle with new squares
- *
- * params:
- *			r - row of subgrid
- *			c - col of subgrid
- *			s - vector of squares to replace current subgrid with
- *****************************************************************/
-void Puzzle::setSub(int r, int c, vector<square> s)
+int Puzzle::getDim()
 {
-	//ensure puzzle is large enough
-	if(_squares.size() != (_dim*_dim)){
-		_squares.resize(_dim*_dim);
-	}
-	// find top left square of grid containing square in row, col
-	int row = r - r%3;
-	int col = c - c%3;
-	int indx = 0;
-	for (int i = 0; i < 3; i++)
-	{
-		//convert to 1D coords
-		int pos = ((row + i) * _dim) + col;
-		//overwrite values in subgrid with new ones
-		for (int p = pos; p < pos + 3; p++)
-		{
-			_squares[p] = s[indx];
-			indx++;
-		}
-	}
+	return BOARD_DIM;
 }
 
 /******************************************************************
- * getRow(int r)
- * returns a row of the puzzle as a vector
+ * getValue(int pos)
+ * Returns the value of a square
  *
  * params:
- *			r - row to return
- * returns: a vector of squares from row r
+ *			pos - the 1D position of the square
+ * returns: the char symbol in the square
  *****************************************************************/
-vector<square> Puzzle::getRow(int r){
-	std::vector<square> row;
-	int pos = r*_dim; //get 1D start pos of row
-	for( int i = 0; i < _dim; i++){
-		row.push_back(_squares[pos+i]);
-	}
-	return row;
-}
-
-/******************************************************************
- * getCol(int c)
- * returns a col of the puzzle as a vector
- *
- * params:
- *			c - col to return
- * returns: a vector of squares from col c
- *****************************************************************/
-vector<square> Puzzle::getCol(int c){
-	std::vector<square> col;
-	for( int i = c; i < (_dim*_dim) + c; i += _dim){
-		col.push_back(_squares[i]);
-	}
-	return col;
-}
-
-/******************************************************************
- * getSub(int r, int c)
- * returns a subgrid from the puzzle
- *
- * params:
- *			r - row of subgrid
- *			c - col of subgrid
- * returns: a vector of squares from the specified subgrid
- *****************************************************************/
-vector<square> Puzzle::getSub(int r, int c)
+char Puzzle::getValue(int pos) const
 {
-	std::vector<square> sub;
-	//get subgrid from r and c
-	int row = r - r%3;
-	int col = c - c%3;
-	//walk subgrid filling vector with squares
-	for (int i = 0; i < 3; i++)
-	{
-		int pos = ((row + i) * _dim) + col;
-		for (int p = pos; p < pos + 3; p++)
-		{
-			sub.push_back(_squares[p]);
-		}
-	}
-	return sub;
+	return _values[pos];
 }
 
 /******************************************************************
- * getSquares()
- * returns all squares from the puzzle
+ * setValue(int pos, char val)
+ * Set the value of a square directly, without updating the tallies.
+ * Use this to fill a puzzle, then call evaluateFitness.
  *
- * returns: a vector of all squares
+ * params:
+ *			pos - the 1D position of the square
+ *			val - the new value of the square
  *****************************************************************/
-vector<square> Puzzle::getSquares()
+void Puzzle::setValue(int pos, char val)
 {
-	return _squares;
+	_values[pos] = val;
 }
 
 /******************************************************************
@@ -268,22 +111,22 @@ void Puzzle::print(bool duplicates)
 	int row_dupe = 0;
 	std::vector<int> col_dupes;
 	//walk puzzle
-	for(int i = 0; i < (_dim*_dim); i++)
+	for(int i = 0; i < BOARD_SQUARES; i++)
 	{
-		cout << _squares[i].getValue();
+		cout << _values[i];
 		c++;
 		//if at end of subgrid, print space before the next one
-		if (c % (int)(sqrt(_dim)) == 0)
+		if (c % BOARD_SUBDIM == 0)
 		{
 			cout << "  ";
 		}
 		//if we are at the end of a row, newline
-		if (c % _dim == 0)
+		if (c % BOARD_DIM == 0)
 		{
 			if(duplicates)
 			{
 				//print * if duplicates in row
-				row_dupe = countDuplicates(getRow(r));
+				row_dupe = countDuplicates(r * BOARD_DIM, 1);
 				for (int x = 0; x < row_dupe; x++)
 					cout << "*";
 			}
@@ -292,7 +135,7 @@ void Puzzle::print(bool duplicates)
 			//increment row counter
 			r++;
 			//if we are at the end of the subgrid row print a newline for separation
-			if (r%(int)(sqrt(_dim)) == 0)
+			if (r%BOARD_SUBDIM == 0)
 			{
 				cout << endl;
 			}
@@ -304,15 +147,15 @@ void Puzzle::print(bool duplicates)
 	{
 		//print col duplicates
 		c = 0;
-		while (c < _dim)
+		while (c < BOARD_DIM)
 		{
-			if (countDuplicates(getCol(c)))
+			if (countDuplicates(c, BOARD_DIM))
 				cout << "*"; //duplicate
 			else
 				cout << " "; //np dupes, pad with space
 			c++;
 			//if we are at a new subgrid, space again
-			if (c % (int)(sqrt(_dim)) == 0)
+			if (c % BOARD_SUBDIM == 0)
 			{
 				cout << "  ";
 			}
@@ -323,90 +166,166 @@ void Puzzle::print(bool duplicates)
 
 
 /******************************************************************
- * evaluatePossibleValues()
- * eliminate all possible values from each square
+ * evaluateFitness()
+ * We define a solution's fitness by the number of duplicate symbols
+ * throughout all rows and columns.  This function assigns a fitness
+ * to the puzzle.
+ *
+ * A row or column with no duplicates holds every value once, so its
+ * duplicate count is just the number of values missing from it. The
+ * value tallies for each row and column are rebuilt here so later
+ * changes can update the fitness incrementally.
  *****************************************************************/
-void Puzzle::evaluatePossibleValues()
+void Puzzle::evaluateFitness()
 {
-	for(int pos = 0; pos < (_dim * _dim); pos++)
+	fitness = 0;
+
+	for (int i = 0; i < BOARD_DIM; i++)
 	{
-		eliminateValues(_squares[pos], pos);
+		_row_tally[i].fill(0);
+		_col_tally[i].fill(0);
 	}
+
+	// tally the values in each row and column, skipping blanks
+	for (int pos = 0; pos < BOARD_SQUARES; pos++)
+	{
+		int value = valueIndex(_values[pos]);
+		if (value >= 0 && value < BOARD_DIM)
+		{
+			_row_tally[BOARD.row[pos]][value]++;
+			_col_tally[BOARD.col[pos]][value]++;
+		}
+	}
+
+	for (int i = 0; i < BOARD_DIM; i++)
+	{
+		fitness += countMissing(_row_tally[i]);
+		fitness += countMissing(_col_tally[i]);
+	}
+	_tallied = true;
 }
 
 /******************************************************************
- * eliminateValues(square &s, int pos)
- * Eliminate possible square values for a particular square.
- * We can eliminate possible square values if that square's symbol
- * exists elsewhere in the row, col, and subgrid
+ * replaceValue(int pos, char val)
+ * Set the value of a single square and update the fitness using
+ * the row and column tallies. Only the square's row and column are
+ * touched, so this runs in constant time.
  *
  * params:
- *			s - the square to eliminate values from
  *			pos - the 1D position of the square in the puzzle
+ *			val - the new value of the square
  *****************************************************************/
-void Puzzle::eliminateValues(square &s, int pos)
+void Puzzle::replaceValue(int pos, char val)
 {
-	int c = pos % _dim;
-	int r = pos / _dim;
-	// eliminate values that are in square's row
-	vector<square> row = getRow(r);
-	for(int i = 0; i < row.size(); i++){
-		if(row[i].getValue() != '-')
-		{
-			s.togglePossible(row[i].getValue());
-		}
-	}
+	// tallies are built on first use if the puzzle was never evaluated
+	if (!_tallied)
+		evaluateFitness();
 
-	// eliminate values that are in square's column
-	vector<square> col = getCol(c);
-	for(int i = 0; i < col.size(); i++){
-		if(col[i].getValue() != '-')
-		{
-			s.togglePossible(col[i].getValue());
-		}		
-	}
-	
-	// eliminate values that are in square's grid
-	vector<square> sub = getSub(r,c);
-	for(int i = 0; i < sub.size(); i++){
-		if(sub[i].getValue() != '-')
-		{
-			s.togglePossible(sub[i].getValue());
-		}
-	}
+	int old_value = valueIndex(_values[pos]);
+	int new_value = valueIndex(val);
+
+	_values[pos] = val;
+	if (old_value == new_value)
+		return;
+
+	fitness += retally(_row_tally[BOARD.row[pos]], old_value, new_value);
+	fitness += retally(_col_tally[BOARD.col[pos]], old_value, new_value);
 }
 
 /******************************************************************
- * evaluateFitness()
- * We define a solution's fitness by the number of duplicate symbols
- * throughout all rows and columns.  This function assigns a fitness
- * to the puzzle.
+ * swapSquares(int pos1, int pos2)
+ * Swap the values of two squares, updating the fitness incrementally.
+ * At most two rows and two columns are affected.
+ *
+ * params:
+ *			pos1 - the 1D position of the first square
+ *			pos2 - the 1D position of the second square
  *****************************************************************/
-void Puzzle::evaluateFitness()
+void Puzzle::swapSquares(int pos1, int pos2)
 {
-	fitness = 0;
+	char temp = _values[pos1];
+	replaceValue(pos1, _values[pos2]);
+	replaceValue(pos2, temp);
+}
 
-	for (int i = 0; i < _dim; i++)
+/******************************************************************
+ * hasConflict(int pos)
+ * Check whether a square's value appears more than once in its row
+ * or column, using the tallies.
+ *
+ * params:
+ *			pos - the 1D position of the square
+ * returns: true if the square's value is duplicated in its row or col
+ *****************************************************************/
+bool Puzzle::hasConflict(int pos)
+{
+	if (!_tallied)
+		evaluateFitness();
+
+	int value = valueIndex(_values[pos]);
+	if (value < 0 || value >= BOARD_DIM)
+		return false;
+	return _row_tally[BOARD.row[pos]][value] > 1 || _col_tally[BOARD.col[pos]][value] > 1;
+}
+
+/******************************************************************
+ * countMissing(const array<uint8_t, BOARD_DIM>& tally)
+ * Return the number of values that do not appear in a tallied row or
+ * column. This is the number of duplicates (or blanks) in it.
+ *
+ * params:
+ *			tally - count of each value in the row or column
+ *****************************************************************/
+int Puzzle::countMissing(const std::array<uint8_t, BOARD_DIM>& tally)
+{
+	int missing = 0;
+	for (int v = 0; v < BOARD_DIM; v++)
 	{
-		fitness += countDuplicates(getRow(i));
-		fitness += countDuplicates(getCol(i));
+		if (tally[v] == 0)
+			missing++;
 	}
+	return missing;
+}
+
+/******************************************************************
+ * retally(array<uint8_t, BOARD_DIM>& tally, int out, int in)
+ * Move one count in a row or column tally from one value to another
+ * and return how much the number of missing values changed. Values
+ * outside the puzzle's range (blanks) are not tallied.
+ *
+ * params:
+ *			tally - count of each value in the row or column
+ *			out - the value index leaving the row or column
+ *			in - the value index entering the row or column
+ * returns: the change in fitness caused by the move
+ *****************************************************************/
+int Puzzle::retally(std::array<uint8_t, BOARD_DIM>& tally, int out, int in)
+{
+	int change = 0;
+	// the last copy of a value leaving makes it missing
+	if (out >= 0 && out < BOARD_DIM && --tally[out] == 0)
+		change++;
+	// the first copy of a value arriving fills it in
+	if (in >= 0 && in < BOARD_DIM && tally[in]++ == 0)
+		change--;
+	return change;
 }
 
 /******************************************************************
- * countDuplicates(vector<square> list)
- * Return the number of duplicates in a list of squares
+ * countDuplicates(int first, int step)
+ * Return the number of duplicates (or blanks) in a row or column
  *
  * params:
- *			list - vector of squares to count duplicates from
+ *			first - 1D position of the first square in the row or col
+ *			step - distance between squares (1 for a row, dim for a col)
  *****************************************************************/
-int Puzzle::countDuplicates(vector<square> list){
-	bool seen[9] = {0};
+int Puzzle::countDuplicates(int first, int step){
+	bool seen[BOARD_DIM] = {0};
 	int duplicates = 0;
 
-	for(int i = 0; i < list.size(); i++){
-		int value = (list[i].getValue() - '0') - 1;
-		if (!seen[value])
+	for(int i = 0; i < BOARD_DIM; i++){
+		int value = valueIndex(_values[first + (i * step)]);
+		if (value >= 0 && value < BOARD_DIM && !seen[value])
 			seen[value] = true;
 		//if we have seen it, we have a duplicate, increment duplicates
 		else
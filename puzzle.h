@@ -1,60 +1,68 @@
  /************************************************************************
    File: puzzle.h
-   Authors: Katie MacMillian, Jake Davidson
+   Authors: Katie MacMillan, Jake Davidson
    Description: Header file for the puzzle class. The puzzle class contains 
-   a list of square objects that make up the puzzle (1D row major) as well 
-   as other data about the puzzle, such as it's fitness and dimension.
+   the values of the squares that make up the puzzle (1D row major) as well 
+   as other data about the puzzle, such as it's fitness and dimension. A 
+   puzzle is one member of the population, so it only holds what differs 
+   between members. Anything shared by the whole population (preset flags, 
+   possible values, free squares) lives in the ProblemContext.
 
-   Usage: You can create a puzzle with just a dimension, which will make all 
-   squares have a blank value. You can also use the copy constructor to copy 
-   an already existing puzzle. Once created, there are multiple ways to fill 
-   it with values, using the set functions. You can set rows, columns, and 
-   subgrids, or set one square at a time with addSquare(). Once filled, 
-   evaluateFitness will assign a rank to the puzzle based on how correct 
-   the puzzle is (defined as the number of duplicates in rows and columns).
+   Usage: A new puzzle has a blank value in every square. Fill it one square 
+   at a time with setValue(). Once filled, evaluateFitness will assign a rank to the puzzle 
+   based on how correct the puzzle is (defined as the number of duplicates 
+   in rows and columns).
+
+   evaluateFitness also tallies how many times each value appears in every 
+   row and column. Once tallied, replaceValue and swapSquares keep the 
+   tallies and the fitness up to date in constant time, so a mutation or 
+   crossover only pays for the squares it actually changes. Writing a value 
+   with setValue skips the tallies, so evaluateFitness must be called again 
+   before relying on the fitness afterwards.
+
+   The values are kept in a fixed size array sized at compile time for the 
+   board order of the build (see boardorder.h), so a puzzle never touches 
+   the heap after construction and copying one is a single flat copy.
  ************************************************************************/
 #ifndef __PUZZLE_H_
 #define __PUZZLE_H_
 
+#include <array>
 #include <vector>
 #include <iostream>
 #include <cmath>
-#include <unordered_map>
 #include <algorithm>
-#include "square.h"
+#include <stdint.h>
+#include "boardtables.h"
+
+using namespace std;
 
 class Puzzle
 {
-public:
 	private:
-		std::vector<square> _squares; //the squares of the puzzle, stored in row major format
-		int _dim; //dimension of one side of the puzzle (square puzzles assumed/supported)
-		int _sub_dim; //dimension of subgrid
-		void eliminateValues(square&, int); //eliminate a square's values that it cannot be
-		int countDuplicates(vector<square>); //count the number of duplicates squares in list
+		std::array<char, BOARD_SQUARES> _values; //the values of the squares, stored in row major format
+		std::array<std::array<uint8_t, BOARD_DIM>, BOARD_DIM> _row_tally; //count of each value in each row
+		std::array<std::array<uint8_t, BOARD_DIM>, BOARD_DIM> _col_tally; //count of each value in each col
+		bool _tallied; //true if the row and col tallies match the squares
+		int countDuplicates(int, int); //count the number of duplicates in a row or col
+		int countMissing(const std::array<uint8_t, BOARD_DIM>&); //count the values missing from a tallied row or col
+		int retally(std::array<uint8_t, BOARD_DIM>&, int, int); //move one tally between values, returns the fitness change
 	public:
 		int fitness; //fitness level of the puzzle
-		vector<int> subgrid_presets; // number of preset values in each subgrid
 		//constructors
-		Puzzle(int); //constructor that takes the size of the puzzle
-		Puzzle(const Puzzle&); //copy constructor
+		Puzzle(); //constructor for a blank puzzle
 		//functions
-		void addSquare(square); //add a square to the back of the puzzle
 		int size(); //get the size of the puzzle
+		int getDim(); //get the dimension of the puzzle
+		char getValue(int) const; //get the value of a square
+		void setValue(int, char); //set the value of a square, without updating fitness
 		void print(bool duplicates = true); //print the puzzle in a nice format
-		vector<square> getRow(int); //get a specific row of the puzzle
-		vector<square> getCol(int); //get a specific col of the puzzle
-		vector<square> getSub(int, int); //get a specific subgrid of the puzzle
-		vector<square> getSquares(); //get all the squares in the puzzle
-		void setRow(int, vector<square>); //set a row of the puzzle
-		void setCol(int, vector<square>); //set the col of the puzzle
-		void setSub(int, int, vector<square>); //set the subgrid of the puzzle
-		void evaluatePossibleValues(); //eliminate possible values for all squares in puzzle
 		void evaluateFitness(); //set the puzzle's fitness level
+		void replaceValue(int, char); //set a square's value, updating fitness incrementally
+		void swapSquares(int, int); //swap the values of two squares, updating fitness incrementally
+		bool hasConflict(int); //check if a square's value is duplicated in its row or col
 
 		//overloaded operators
-		square operator [] (int) const; //access a square with []
-		square & operator [] (int); //assign to a square with []
 		bool operator < (const Puzzle& puz) const; //compare two puzzle's using fitness
 };
-#endif
\ No newline at end of file
+#endif
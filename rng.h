@@ -0,0 +1,143 @@
+ /************************************************************************
+   File: rng.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Header file for the Rng class, a small xoshiro256** random
+   number generator. Unlike rand(), each Rng object carries its own state,
+   so threads never contend on a shared generator and a run can be
+   reproduced exactly from its seed.
+
+   Usage: Construct an Rng from a master seed and a stream number. Streams
+   with different numbers are independent, so parallel work can derive one
+   stream per task (for example per breeding pair) and get the same
+   results no matter which thread runs the task. The functions are defined
+   here so they can be inlined into the breeding loops.
+ ************************************************************************/
+#ifndef __RNG_H_
+#define __RNG_H_
+
+#include <stdint.h>
+#include <utility>
+
+class Rng
+{
+	public:
+		// Constructors
+		Rng(uint64_t seed = 0, uint64_t stream = 0) { reseed(seed, stream); }
+
+		// Setters
+		void reseed(uint64_t, uint64_t = 0); //restart the generator on a seed and stream
+
+		// Others
+		uint64_t next(); //next 64 random bits
+		int below(int); //random integer in [0, n)
+		double uniform(); //random double in [0, 1)
+		template <class It> void shuffle(It, It); //Fisher-Yates shuffle of a range
+
+	private:
+		uint64_t _state[4]; //xoshiro256 state
+		static uint64_t splitMix(uint64_t&); //seed expansion step
+		static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+/******************************************************************
+ * splitMix(uint64_t &x)
+ * One step of splitmix64, used to spread a seed across the state
+ *
+ * params:
+ *			x - splitmix state, advanced in place
+ * returns: the next splitmix output
+ *****************************************************************/
+inline uint64_t Rng::splitMix(uint64_t &x)
+{
+	uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/******************************************************************
+ * reseed(uint64_t seed, uint64_t stream)
+ * Restart the generator. The stream number is hashed together with
+ * the seed, so neighbouring streams produce unrelated sequences.
+ *
+ * params:
+ *			seed - master seed for the run
+ *			stream - which independent stream to start
+ *****************************************************************/
+inline void Rng::reseed(uint64_t seed, uint64_t stream)
+{
+	uint64_t x = seed;
+	x ^= splitMix(stream);
+	for (int i = 0; i < 4; i++)
+	{
+		_state[i] = splitMix(x);
+	}
+}
+
+/******************************************************************
+ * next()
+ * Advance the generator
+ *
+ * returns: 64 random bits
+ *****************************************************************/
+inline uint64_t Rng::next()
+{
+	uint64_t result = rotl(_state[1] * 5, 7) * 9;
+	uint64_t t = _state[1] << 17;
+
+	_state[2] ^= _state[0];
+	_state[3] ^= _state[1];
+	_state[1] ^= _state[2];
+	_state[0] ^= _state[3];
+	_state[2] ^= t;
+	_state[3] = rotl(_state[3], 45);
+
+	return result;
+}
+
+/******************************************************************
+ * below(int n)
+ * Random integer in [0, n) using a multiply and shift rather than a
+ * modulo, which avoids both the division and most of the bias.
+ *
+ * params:
+ *			n - exclusive upper bound, must be positive
+ * returns: a random integer from 0 to n-1
+ *****************************************************************/
+inline int Rng::below(int n)
+{
+	return (int)(((next() >> 32) * (uint64_t)n) >> 32);
+}
+
+/******************************************************************
+ * uniform()
+ * Random double in [0, 1), built from the top 53 bits so every
+ * value is equally likely.
+ *
+ * returns: a random double from 0 up to but not including 1
+ *****************************************************************/
+inline double Rng::uniform()
+{
+	return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/******************************************************************
+ * shuffle(It first, It last)
+ * Fisher-Yates shuffle of a random access range. Unlike the STL
+ * shuffles the result depends only on the generator state, so it is
+ * the same on every platform.
+ *
+ * params:
+ *			first - start of the range
+ *			last - end of the range
+ *****************************************************************/
+template <class It>
+inline void Rng::shuffle(It first, It last)
+{
+	for (int i = (int)(last - first) - 1; i > 0; i--)
+	{
+		std::swap(first[i], first[below(i + 1)]);
+	}
+}
+
+#endif
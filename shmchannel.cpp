@@ -0,0 +1,240 @@
+ /************************************************************************
+   File: shmchannel.cpp
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Function definitions for the ShmChannel class. The rings
+   work like SpscQueue, with each process only writing the tail of its
+   own ring and the head of the ring before it, but the slots hold
+   genomes rather than puzzles so that nothing in the segment has
+   pointers or depends on where it is mapped.
+ ************************************************************************/
+#include "shmchannel.h"
+#include "genome.h"
+#include "islands.h"
+#include <atomic>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// most processes a ring can hold, an island can run a lap of the ring ahead
+const int SHM_MAX_RANKS = (SHM_RING_SLOTS / ISLAND_MIGRANTS) - 1;
+
+// atomics in the segment are shared between processes, which only works if they never take a lock
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_LONG_LOCK_FREE == 2, "shared memory rings need lock free 64 bit atomics");
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "shared memory rings need lock free 32 bit atomics");
+
+/******************************************************************************
+ * ShmRing
+ * The genomes one process sends to the next. Lock free atomics work between
+ * processes on the same machine since they never rely on a lock.
+ *****************************************************************************/
+struct ShmRing
+{
+	std::atomic<uint64_t> head; //next slot to read, only written by the next process
+	char pad[64]; //keeps the head and tail on different cache lines
+	std::atomic<uint64_t> tail; //next slot to write, only written by this process
+	std::atomic<uint32_t> finished; //set once this process has stopped
+	uint8_t slots[SHM_RING_SLOTS][GENOME_BYTES];
+};
+
+/******************************************************************************
+ * ShmSegment
+ * The layout of the shared memory segment. A new segment is filled with
+ * zeros, which is a valid empty state for every field.
+ *****************************************************************************/
+struct ShmSegment
+{
+	std::atomic<uint32_t> hash; //hash of the puzzle being solved, 0 until the first process sets it
+	std::atomic<uint32_t> attached; //processes that have the segment open
+	std::atomic<uint32_t> solved; //set once any process solves the puzzle
+	ShmRing rings[1]; //one ring per process, the segment is sized for all of them
+};
+
+/***************
+ * Constructors
+ ***************/
+
+/******************************************************************
+ * ShmChannel()
+ * Constructor for a channel that has not been opened.
+ *****************************************************************/
+ShmChannel::ShmChannel()
+{
+	_segment = NULL;
+	_size = 0;
+	_rank = 0;
+	_ranks = 0;
+	_problem = NULL;
+}
+
+/******************************************************************
+ * ~ShmChannel()
+ * Mark this process as finished so the next process stops waiting
+ * on it, and unmap the segment. The last process to leave removes
+ * the segment.
+ *****************************************************************/
+ShmChannel::~ShmChannel()
+{
+	if (_segment == NULL)
+		return;
+
+	_segment->rings[_rank].finished.store(1);
+	bool last = (_segment->attached.fetch_sub(1) == 1);
+	munmap(_segment, _size);
+	if (last)
+	{
+		shm_unlink(_name.c_str());
+	}
+}
+
+/***************
+ * Functions
+ ***************/
+
+/******************************************************************
+ * open(const string &name, int rank, int ranks, const ProblemContext &problem, string &error)
+ * Create or map the shared memory segment and join the ring. The
+ * puzzle hash is checked against the one the first process stored,
+ * so processes solving different puzzles can not share a segment.
+ * The first process to join clears whatever a run before it left in
+ * the segment, so a finished run's solved flag never stops the next.
+ * A process that can not join leaves the segment as it found it.
+ *
+ * params:
+ *			name - the segment name, starting with '/'
+ *			rank - this process's position in the ring
+ *		   ranks - the number of processes in the ring
+ *		 problem - the puzzle being solved
+ *		   error - receives why the ring could not be joined
+ * returns: true if the channel is ready
+ *****************************************************************/
+bool ShmChannel::open(const string &name, int rank, int ranks, const ProblemContext &problem, string &error)
+{
+	if (ranks < 2 || ranks > SHM_MAX_RANKS || rank < 0 || rank >= ranks)
+	{
+		error = "Shared memory rings need 2 to " + to_string(SHM_MAX_RANKS) + " ranks and a rank below them.";
+		return false;
+	}
+
+	_name = (name[0] == '/') ? name : "/" + name;
+	_size = sizeof(ShmSegment) + ((ranks - 1) * sizeof(ShmRing));
+	_rank = rank;
+	_ranks = ranks;
+	_problem = &problem;
+
+	int fd = shm_open(_name.c_str(), O_RDWR | O_CREAT, 0600);
+	if (fd < 0)
+	{
+		error = "Could not open shared memory " + _name + ".";
+		return false;
+	}
+
+	// every process sets the same size, and new pages are zero filled
+	struct stat info;
+	bool sized = (fstat(fd, &info) == 0) && ((size_t)info.st_size == _size || ftruncate(fd, _size) == 0);
+	void *mapping = sized ? mmap(NULL, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+	close(fd);
+	if (mapping == MAP_FAILED)
+	{
+		error = "Could not map shared memory " + _name + ".";
+		return false;
+	}
+	ShmSegment *segment = (ShmSegment*)mapping;
+	if (segment->attached.fetch_add(1) == 0)
+	{
+		// nobody else is in the ring yet, so start it from empty
+		segment->hash.store(0);
+		segment->solved.store(0);
+		for (int r = 0; r < ranks; r++)
+		{
+			segment->rings[r].head.store(0);
+			segment->rings[r].tail.store(0);
+			segment->rings[r].finished.store(0);
+		}
+	}
+
+	uint32_t hash = puzzleHash(problem);
+	uint32_t expected = 0;
+	if (!segment->hash.compare_exchange_strong(expected, hash) && expected != hash)
+	{
+		// leave without marking a ring finished, the segment belongs to another run
+		bool last = (segment->attached.fetch_sub(1) == 1);
+		munmap(segment, _size);
+		if (last)
+		{
+			shm_unlink(_name.c_str());
+		}
+		error = "Shared memory " + _name + " is being used for a different puzzle.";
+		return false;
+	}
+	_segment = segment;
+	return true;
+}
+
+/******************************************************************
+ * send(const Puzzle &puz)
+ * Encode a migrant into this process's ring.
+ *
+ * params:
+ *			puz - the migrant to send
+ * returns: false if the ring is full
+ *****************************************************************/
+bool ShmChannel::send(const Puzzle &puz)
+{
+	ShmRing &ring = _segment->rings[_rank];
+	uint64_t tail = ring.tail.load(memory_order_relaxed);
+	if (tail - ring.head.load(memory_order_acquire) == SHM_RING_SLOTS)
+		return false;
+
+	encodeGenome(*_problem, puz, ring.slots[tail % SHM_RING_SLOTS]);
+	ring.tail.store(tail + 1, memory_order_release);
+	return true;
+}
+
+/******************************************************************
+ * receive(Puzzle &puz)
+ * Decode a migrant from the ring of the process before this one.
+ * A genome which fails to decode is dropped.
+ *
+ * params:
+ *			puz - receives the migrant
+ * returns: whether a migrant was taken, dropped or not waiting
+ *****************************************************************/
+ReceiveResult ShmChannel::receive(Puzzle &puz)
+{
+	ShmRing &ring = _segment->rings[(_rank + _ranks - 1) % _ranks];
+	uint64_t head = ring.head.load(memory_order_relaxed);
+	if (head == ring.tail.load(memory_order_acquire))
+		return RECEIVE_NOTHING;
+
+	Puzzle migrant;
+	bool valid = decodeGenome(*_problem, ring.slots[head % SHM_RING_SLOTS], migrant);
+	ring.head.store(head + 1, memory_order_release);
+	if (!valid)
+		return RECEIVE_DROPPED;
+
+	puz = migrant;
+	return RECEIVE_MIGRANT;
+}
+
+/******************************************************************
+ * announceSolved()
+ * Tell every process in the ring that the puzzle is solved.
+ *****************************************************************/
+void ShmChannel::announceSolved()
+{
+	_segment->solved.store(1);
+}
+
+/******************************************************************
+ * stopped()
+ * Check whether this process should stop.
+ *
+ * returns: true once the puzzle is solved, or the process before
+ *			this one has stopped sending migrants
+ *****************************************************************/
+bool ShmChannel::stopped()
+{
+	int prev = (_rank + _ranks - 1) % _ranks;
+	return _segment->solved.load(memory_order_relaxed) || _segment->rings[prev].finished.load(memory_order_relaxed);
+}
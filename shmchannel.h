@@ -0,0 +1,54 @@
+ /************************************************************************
+   File: shmchannel.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Header file for the ShmChannel class, the migration
+   channel between island processes on one machine. Every process in the
+   ring maps the same POSIX shared memory segment, which holds one lock
+   free single producer, single consumer ring of genomes per process,
+   along with a solved flag and a finished flag for each process.
+
+   Usage: Start every process with the same segment name, the same number
+   of ranks and a different rank, then call open(). The segment is
+   created by whichever process gets there first, and removed by the last
+   process to close it. The first process to join also clears anything a
+   finished run left in it. A segment left behind by a crashed run still
+   counts the crashed processes as joined, so it should be removed (from
+   /dev/shm) or a new name used.
+ ************************************************************************/
+#ifndef __SHM_CHANNEL_H_
+#define __SHM_CHANNEL_H_
+
+#include <string>
+#include <stddef.h>
+#include "migration.h"
+#include "problemcontext.h"
+
+// genome slots in each process's ring
+const int SHM_RING_SLOTS = 64;
+
+struct ShmSegment;
+
+class ShmChannel : public MigrationChannel
+{
+	public:
+		// Constructors
+		ShmChannel();
+		~ShmChannel();
+
+		// Others
+		bool open(const std::string&, int, int, const ProblemContext&, std::string&); //map the segment and join the ring
+		bool send(const Puzzle&);
+		ReceiveResult receive(Puzzle&);
+		void announceSolved();
+		bool stopped();
+
+	private:
+		std::string _name; //name of the shared memory segment
+		ShmSegment *_segment; //the mapped segment, NULL until opened
+		size_t _size; //size of the mapping in bytes
+		int _rank; //this process's position in the ring
+		int _ranks; //number of processes in the ring
+		const ProblemContext *_problem; //the puzzle being solved, which genomes are read against
+};
+
+#endif
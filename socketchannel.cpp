@@ -0,0 +1,443 @@
+ /************************************************************************
+   File: socketchannel.cpp
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Function definitions for the SocketChannel class. The
+   socket to the next process is left blocking, since messages are small
+   and only a few are sent each migration. The socket from the process
+   before is non-blocking, and whatever has arrived on it is read into a
+   buffer and split into messages whenever the island checks for
+   migrants or for a solve.
+ ************************************************************************/
+#include "socketchannel.h"
+#include "genome.h"
+#include <chrono>
+#include <thread>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+
+// message types
+const uint8_t MESSAGE_HELLO = 1;
+const uint8_t MESSAGE_MIGRANT = 2;
+const uint8_t MESSAGE_SOLVED = 3;
+
+static int openSocket(const string&, bool);
+static int payloadSize(const ProblemContext&, uint8_t);
+
+/***************
+ * Constructors
+ ***************/
+
+/******************************************************************
+ * SocketChannel()
+ * Constructor for a channel that has not been opened.
+ *****************************************************************/
+SocketChannel::SocketChannel()
+{
+	_outbound = -1;
+	_inbound = -1;
+	_solved = false;
+	_solved_sent = false;
+	_closed = false;
+	_problem = NULL;
+}
+
+/******************************************************************
+ * ~SocketChannel()
+ * Close both sockets, which tells the neighbours this process has
+ * stopped, and remove the listening Unix socket if there was one.
+ *****************************************************************/
+SocketChannel::~SocketChannel()
+{
+	if (_outbound >= 0)
+		close(_outbound);
+	if (_inbound >= 0)
+		close(_inbound);
+	if (!_unix_path.empty())
+		unlink(_unix_path.c_str());
+}
+
+/***************
+ * Functions
+ ***************/
+
+/******************************************************************
+ * open(const string &listen_at, const string &next, const ProblemContext &problem, string &error)
+ * Join the ring. The listening socket is opened first, so the
+ * process before can connect as soon as it likes, then the
+ * connection to the next process is made (retrying until it is
+ * listening) and the connection from the process before is
+ * accepted. Both neighbours then swap hellos, and a process solving
+ * a different puzzle is refused. Each wait gives up after
+ * SOCKET_CONNECT_WAIT seconds.
+ *
+ * params:
+ *		listen_at - the address to accept the process before on
+ *			 next - the address of the next process
+ *		  problem - the puzzle being solved
+ *			error - receives why the ring could not be joined
+ * returns: true if the channel is ready
+ *****************************************************************/
+bool SocketChannel::open(const string &listen_at, const string &next, const ProblemContext &problem, string &error)
+{
+	_problem = &problem;
+	uint32_t hash = puzzleHash(problem);
+
+	int listener = openSocket(listen_at, true);
+	if (listener < 0)
+	{
+		error = "Could not listen on " + listen_at + ".";
+		return false;
+	}
+	if (listen_at.find('/') != string::npos)
+	{
+		_unix_path = listen_at;
+	}
+
+	for (int tries = 0; _outbound < 0 && tries < SOCKET_CONNECT_WAIT * 10; tries++)
+	{
+		_outbound = openSocket(next, false);
+		if (_outbound < 0)
+		{
+			this_thread::sleep_for(chrono::milliseconds(100));
+		}
+	}
+	if (_outbound < 0)
+	{
+		error = "Could not connect to " + next + ".";
+		close(listener);
+		return false;
+	}
+
+	// wait a while for the process before, rather than forever
+	pollfd waiting = {listener, POLLIN, 0};
+	if (::poll(&waiting, 1, SOCKET_CONNECT_WAIT * 1000) <= 0)
+	{
+		error = "No process connected on " + listen_at + " within " + to_string(SOCKET_CONNECT_WAIT) + " seconds.";
+		close(listener);
+		return false;
+	}
+	_inbound = accept(listener, NULL, NULL);
+	close(listener);
+	if (_inbound < 0)
+	{
+		error = "Could not accept a connection on " + listen_at + ".";
+		return false;
+	}
+
+	// swap hellos, reading the whole reply before going non-blocking
+	uint8_t hello[4] = {(uint8_t)hash, (uint8_t)(hash >> 8), (uint8_t)(hash >> 16), (uint8_t)(hash >> 24)};
+	writeMessage(MESSAGE_HELLO, hello, sizeof(hello));
+	timeval wait = {SOCKET_CONNECT_WAIT, 0};
+	setsockopt(_inbound, SOL_SOCKET, SO_RCVTIMEO, &wait, sizeof(wait));
+	uint8_t reply[5];
+	int got = 0;
+	while (got < (int)sizeof(reply))
+	{
+		int n = recv(_inbound, reply + got, sizeof(reply) - got, 0);
+		if (n <= 0)
+			break;
+		got += n;
+	}
+	if (got < (int)sizeof(reply))
+	{
+		error = "The process before did not say hello within " + to_string(SOCKET_CONNECT_WAIT) + " seconds.";
+		return false;
+	}
+	uint32_t their_hash = reply[1] | (reply[2] << 8) | (reply[3] << 16) | ((uint32_t)reply[4] << 24);
+	if (reply[0] != MESSAGE_HELLO || their_hash != hash)
+	{
+		error = "The process before is solving a different puzzle.";
+		return false;
+	}
+
+	fcntl(_inbound, F_SETFL, fcntl(_inbound, F_GETFL) | O_NONBLOCK);
+	return !_closed;
+}
+
+/******************************************************************
+ * send(const Puzzle &puz)
+ * Send a migrant to the next process as a genome.
+ *
+ * params:
+ *			puz - the migrant to send
+ * returns: false if the next process has gone away
+ *****************************************************************/
+bool SocketChannel::send(const Puzzle &puz)
+{
+	if (_closed)
+		return false;
+
+	uint8_t genome[GENOME_BYTES];
+	encodeGenome(*_problem, puz, genome);
+	return writeMessage(MESSAGE_MIGRANT, genome, genomeLength(*_problem));
+}
+
+/******************************************************************
+ * receive(Puzzle &puz)
+ * Take the oldest migrant that has arrived from the process before.
+ * A genome which fails to decode is dropped.
+ *
+ * params:
+ *			puz - receives the migrant
+ * returns: whether a migrant was taken, dropped or not waiting
+ *****************************************************************/
+ReceiveResult SocketChannel::receive(Puzzle &puz)
+{
+	poll();
+	if (_genomes.empty())
+		return RECEIVE_NOTHING;
+
+	Puzzle migrant;
+	bool valid = decodeGenome(*_problem, _genomes.front().data(), migrant);
+	_genomes.pop_front();
+	if (!valid)
+		return RECEIVE_DROPPED;
+
+	puz = migrant;
+	return RECEIVE_MIGRANT;
+}
+
+/******************************************************************
+ * announceSolved()
+ * Tell the next process the puzzle is solved. Each process passes
+ * this on once, so it travels all the way around the ring.
+ *****************************************************************/
+void SocketChannel::announceSolved()
+{
+	_solved = true;
+	if (!_solved_sent)
+	{
+		_solved_sent = true;
+		writeMessage(MESSAGE_SOLVED, NULL, 0);
+	}
+}
+
+/******************************************************************
+ * stopped()
+ * Check whether this process should stop.
+ *
+ * returns: true once the puzzle is solved or a neighbour has gone
+ *****************************************************************/
+bool SocketChannel::stopped()
+{
+	poll();
+	return _solved || _closed;
+}
+
+/******************************************************************
+ * writeMessage(uint8_t type, const uint8_t *payload, int size)
+ * Send one message to the next process, blocking until it is all
+ * written.
+ *
+ * params:
+ *			type - the message type
+ *		 payload - the message payload, which may be NULL when size is 0
+ *			size - the payload size in bytes
+ * returns: false if the next process has gone away
+ *****************************************************************/
+bool SocketChannel::writeMessage(uint8_t type, const uint8_t *payload, int size)
+{
+	vector<uint8_t> message(1 + size);
+	message[0] = type;
+	if (size > 0)
+	{
+		memcpy(message.data() + 1, payload, size);
+	}
+
+	size_t sent = 0;
+	while (sent < message.size())
+	{
+		ssize_t n = ::send(_outbound, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+		{
+			_closed = true;
+			return false;
+		}
+		sent += n;
+	}
+	return true;
+}
+
+/******************************************************************
+ * poll()
+ * Read whatever has arrived from the process before and split it
+ * into messages. Migrants are queued for receive(), and word of a
+ * solve is passed on to the next process.
+ *****************************************************************/
+void SocketChannel::poll()
+{
+	uint8_t chunk[4096];
+	while (!_closed)
+	{
+		ssize_t n = recv(_inbound, chunk, sizeof(chunk), 0);
+		if (n > 0)
+		{
+			_buffer.insert(_buffer.end(), chunk, chunk + n);
+		}
+		else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+		{
+			break;
+		}
+		else
+		{
+			_closed = true;
+		}
+	}
+
+	size_t start = 0;
+	while (start < _buffer.size())
+	{
+		uint8_t type = _buffer[start];
+		int size = payloadSize(*_problem, type);
+		if (size < 0)
+		{
+			// an unknown message means the stream can not be trusted
+			_closed = true;
+			start = _buffer.size();
+			break;
+		}
+		if (start + 1 + size > _buffer.size())
+			break;
+
+		const uint8_t *payload = _buffer.data() + start + 1;
+		if (type == MESSAGE_MIGRANT)
+		{
+			_genomes.push_back(vector<uint8_t>(payload, payload + size));
+		}
+		else if (type == MESSAGE_SOLVED)
+		{
+			announceSolved();
+		}
+		start += 1 + size;
+	}
+	_buffer.erase(_buffer.begin(), _buffer.begin() + start);
+}
+
+/******************************************************************************
+ * openSocket(const string&, bool)
+ *
+ * This function opens a socket for an address. An address containing a '/'
+ * is a Unix socket path. Anything else is a TCP "host:port", or a port alone,
+ * which means any address when listening and this machine when connecting.
+ * Every address a host name resolves to is tried in turn.
+ *
+ * params:
+ *		address - the address to listen on or connect to
+ *	  listening - true to bind and listen, false to connect
+ *
+ * returns: the socket, or -1 if it could not be opened
+ *****************************************************************************/
+static int openSocket(const string &address, bool listening)
+{
+	int fd = -1;
+	int result = -1;
+
+	if (address.find('/') != string::npos)
+	{
+		sockaddr_un addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		if (address.size() >= sizeof(addr.sun_path))
+			return -1;
+		strcpy(addr.sun_path, address.c_str());
+
+		fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+			return -1;
+		if (listening)
+		{
+			unlink(address.c_str());
+			result = bind(fd, (sockaddr*)&addr, sizeof(addr));
+		}
+		else
+		{
+			result = connect(fd, (sockaddr*)&addr, sizeof(addr));
+		}
+	}
+	else
+	{
+		size_t colon = address.rfind(':');
+		string host = (colon == string::npos) ? "" : address.substr(0, colon);
+		string port = (colon == string::npos) ? address : address.substr(colon + 1);
+
+		addrinfo hints;
+		memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+		hints.ai_flags = listening ? AI_PASSIVE : 0;
+		if (host.empty() && !listening)
+			host = "127.0.0.1";
+
+		addrinfo *info = NULL;
+		if (getaddrinfo(host.empty() ? NULL : host.c_str(), port.c_str(), &hints, &info) != 0)
+			return -1;
+
+		// a name may resolve to both IPv6 and IPv4, so try each address until one works
+		for (addrinfo *ai = info; ai != NULL; ai = ai->ai_next)
+		{
+			fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+			if (fd < 0)
+				continue;
+
+			int on = 1;
+			if (listening)
+			{
+				setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+				result = bind(fd, ai->ai_addr, ai->ai_addrlen);
+			}
+			else
+			{
+				setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+				result = connect(fd, ai->ai_addr, ai->ai_addrlen);
+			}
+			if (result == 0)
+				break;
+			close(fd);
+			fd = -1;
+		}
+		freeaddrinfo(info);
+	}
+
+	if (fd >= 0 && result == 0 && listening)
+	{
+		result = listen(fd, 1);
+	}
+	if (fd >= 0 && result != 0)
+	{
+		close(fd);
+		fd = -1;
+	}
+	return fd;
+}
+
+/******************************************************************************
+ * payloadSize(const ProblemContext&, uint8_t)
+ *
+ * This function gives the payload size of each message type.
+ *
+ * params:
+ *		problem - the puzzle being solved
+ *		   type - the message type
+ *
+ * returns: the payload size in bytes, or -1 for an unknown type
+ *****************************************************************************/
+static int payloadSize(const ProblemContext &problem, uint8_t type)
+{
+	if (type == MESSAGE_HELLO)
+		return 4;
+	if (type == MESSAGE_MIGRANT)
+		return genomeLength(problem);
+	if (type == MESSAGE_SOLVED)
+		return 0;
+	return -1;
+}
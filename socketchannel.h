@@ -0,0 +1,59 @@
+ /************************************************************************
+   File: socketchannel.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Header file for the SocketChannel class, the migration
+   channel between island processes over TCP or Unix domain sockets, so
+   the processes of a ring may run on different machines. Each process
+   listens for the process before it and connects to the process after
+   it. Messages are a one byte type followed by a fixed size payload:
+   a hello carrying the puzzle hash, a migrant carrying a genome, or
+   word that the puzzle is solved, which every process passes on.
+
+   Usage: Call open() with the address to listen on and the address of
+   the next process. An address containing a '/' is a Unix socket path,
+   anything else is a TCP "host:port" or just a port. Processes may be
+   started in any order, since connecting is retried for a while.
+ ************************************************************************/
+#ifndef __SOCKET_CHANNEL_H_
+#define __SOCKET_CHANNEL_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include "migration.h"
+#include "problemcontext.h"
+
+// seconds to keep retrying the connection to the next process, and to wait
+// for the process before to connect and say hello
+const int SOCKET_CONNECT_WAIT = 30;
+
+class SocketChannel : public MigrationChannel
+{
+	public:
+		// Constructors
+		SocketChannel();
+		~SocketChannel();
+
+		// Others
+		bool open(const std::string&, const std::string&, const ProblemContext&, std::string&); //listen, connect and exchange hellos
+		bool send(const Puzzle&);
+		ReceiveResult receive(Puzzle&);
+		void announceSolved();
+		bool stopped();
+
+	private:
+		int _outbound; //socket to the next process
+		int _inbound; //socket from the process before
+		std::string _unix_path; //path of the listening Unix socket, removed on close
+		std::vector<uint8_t> _buffer; //bytes received but not yet parsed
+		std::deque<std::vector<uint8_t> > _genomes; //migrants received but not yet taken
+		bool _solved; //the puzzle has been solved by some process
+		bool _solved_sent; //word of the solve has been passed on
+		bool _closed; //a neighbour has gone away
+		const ProblemContext *_problem; //the puzzle being solved, which genomes are read against
+
+		bool writeMessage(uint8_t, const uint8_t*, int); //send one message to the next process
+		void poll(); //read and parse whatever has arrived
+};
+
+#endif
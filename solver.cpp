@@ -0,0 +1,598 @@
+ /************************************************************************
+   File: solver.cpp
+   Authors: Katie MacMillan, Jake Davidson
+   Description: This file contains the Solver class, which solves one
+   puzzle from preprocessing through the chosen engine and reports what
+   it found. A solve with params.VERBOSE set prints its progress and
+   results as it goes, like a single puzzle run of the program, and any
+   other solve runs quietly and only returns the result.
+ ************************************************************************/
+#include "solver.h"
+#include "preprocess.h"
+#include "population.h"
+#include "breed.h"
+#include "exactsolver.h"
+#include "endgame.h"
+#include "anneal.h"
+#include "islands.h"
+#include "shmchannel.h"
+#include "socketchannel.h"
+
+/***************
+ * Constructors
+ ***************/
+
+/******************************************************************
+ * Solver()
+ * Constructor for a solver that has not solved anything yet.
+ *****************************************************************/
+Solver::Solver()
+{
+	_params = NULL;
+}
+
+/***************
+ * Functions
+ ***************/
+
+/******************************************************************************
+ * Solver::solve(const Puzzle&, const Params&)
+ *
+ * This function solves a puzzle. The puzzle's squares go into a new problem
+ * context, every filled in square being a preset value, and the random
+ * generator is seeded from the params' seed and stream, so the same puzzle
+ * and params always give the same result. It begins by filling in every
+ * single that preprocessing can find, and then finds the free squares and
+ * initial puzzle shared by every puzzle the engines build.
+ *
+ * Singles are filled by propagation, so filling one single immediately
+ * rechecks only the squares and units it affects, and every single that can
+ * be found has been found when preprocessing returns. The number of singles
+ * and the time taken are printed with the filled in puzzle.
+ *
+ * When all singles have been filled in, the fitness of the puzzle is
+ * evaluated. If the fitness of the puzzle is 0, it means that the puzzle is
+ * completed and we are done. Otherwise the puzzle goes to the chosen engine:
+ * the exact search, simulated annealing, the island model or a single
+ * population genetic algorithm.
+ *
+ * params:
+ *		puzzle - the puzzle to solve, with blank squares holding '-'
+ *		params - the params to solve it with, which must not change until
+ *				 the solve returns
+ *
+ * returns: the best puzzle found and how long it took to find, or an error
+ *			if the puzzle could not be solved at all
+ *****************************************************************************/
+SolveResult Solver::solve(const Puzzle &puzzle, const Params &params)
+{
+	SolveResult result;
+	auto solve_start = chrono::high_resolution_clock::now();
+
+	// start again from an empty context holding only this puzzle
+	_params = &params;
+	_problem = ProblemContext();
+	for (int pos = 0; pos < BOARD_SQUARES; pos++)
+	{
+		char value = puzzle.getValue(pos);
+		int index = valueIndex(value);
+		if (value != '-' && (index < 0 || index >= BOARD_DIM))
+		{
+			result.best = puzzle;
+			result.error = "Invalid symbol '" + string(1, value) + "' for a " + to_string(BOARD_DIM) + "x" + to_string(BOARD_DIM) + " puzzle.";
+			return result;
+		}
+		_problem.addSquare(square(value, BOARD_DIM, value != '-'));
+	}
+	_rng.reseed(params.SEED, params.STREAM);
+
+	// print original puzzle
+	if (params.VERBOSE)
+	{
+		cout << "********Initial Configuration (" << BOARD_DIM << "x" << BOARD_DIM << " grid)********" << endl;
+		_problem.makePuzzle().print(false);
+	}
+
+	// fill singles of start puzzle, propagating each one until there is no change
+	auto preprocess_start = chrono::high_resolution_clock::now();
+	PreprocessCounts counts;
+	result.singles = preprocessPuzzle(_problem, params.PREPROCESS, counts);
+	auto preprocess_time = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - preprocess_start);
+
+	// find the preset counts, free squares and initial puzzle shared by every puzzle built
+	_problem.evaluatePresets();
+	Puzzle initial_puzzle = _problem.initial_puzzle;
+
+	if (params.VERBOSE)
+	{
+		cout << "********Filled In Predetermined Singles********" << endl;
+		initial_puzzle.print(false);
+		cout << result.singles << " singles filled in " << preprocess_time.count() << " usec" << endl;
+		cout << left << setw(25) << "naked singles: " << counts.naked_singles << endl;
+		cout << left << setw(25) << "hidden singles: " << counts.hidden_singles << endl;
+		cout << left << setw(25) << "pointing candidates: " << counts.pointing << endl;
+		cout << left << setw(25) << "box/line reductions: " << counts.box_line << endl;
+		cout << left << setw(25) << "naked subsets: " << counts.naked_subsets << endl;
+		cout << left << setw(25) << "hidden subsets: " << counts.hidden_subsets << endl;
+		cout << left << setw(25) << "x-wings: " << counts.x_wings << endl << endl;
+	}
+
+	// check if puzzle is done
+	if(initial_puzzle.fitness == 0)
+	{
+		result.best = initial_puzzle;
+		result.solved = true;
+		result.preprocessed = true;
+		if (params.VERBOSE)
+		{
+			cout << "**********Puzzle Complete After Filling Singles**********" << endl;
+			initial_puzzle.print();
+		}
+	}
+	else if (params.ENGINE == 1)
+	{
+		solveExactly(result);
+	}
+	else if (params.ENGINE == 2)
+	{
+		solveAnnealing(result);
+	}
+	else if ((params.ISLANDS > 1) || !params.SHM_NAME.empty() || !params.LISTEN.empty())
+	{
+		solveIslands(result);
+	}
+	else
+	{
+		solveGenetic(result);
+	}
+
+	chrono::duration<double, milli> millisec = chrono::high_resolution_clock::now() - solve_start;
+	result.msec = millisec.count();
+	return result;
+}
+
+/******************************************************************************
+ * Solver::solveGenetic(SolveResult&)
+ *
+ * This function executes the nested do loops in an attempt to solve the 
+ * initial puzzle. The best puzzle found during the course of running is saved
+ * in a Puzzle variable called 'best_puzzle'. It initially begins as the
+ * inital puzzle.
+ *
+ * The outter do-while loop begins by creating a new population, assessing the
+ * fittness of each puzzle in the population, and then sorting the population
+ * in ascending order based on fitness. When this is done a handful of
+ * variables are reset to their starting positions to begin the breeding phase
+ * for the newly generated population.
+ *
+ * During the inner do-while loop the breeding phase occurs. In this loop the
+ * population is either breed, or mutated to create subsequent generations.
+ * The 'population' vector is replaced with the new generation, and then each
+ * puzzle in has its fitness assesed, and then the population is sorted based
+ * on fitness.
+ * 
+ * After sorting the population the fitness of the first puzzle in the 
+ * population is compared to the value stored in 'best_fitness'. If both
+ * values are the same, the best_fitness_ct is incremented. This is to indicate
+ * how many generations have passed without a changing top puzzle fitness.
+ *
+ * If the best_fitness_ct counter reaches 15, it indicates a significant level
+ * of stagnation. In these cases the program begins to increase the mutation
+ * rate by 5% for each subsequent generation with the same best fitness value.
+ * The mutation rate does not, however, exceed 100%.
+ *
+ * When the first puzzle's fitness is not the same as the 'best_fitness', the
+ * counter is reset to 0, and the mutation rate is set back to the original
+ * starting mutation rate.
+ * 
+ * When this is done the fitness of the best puzzle in the new
+ * generation, now stored in the population vector, is compared to the fitness
+ * of the puzzle stored in the 'best_puzzle' variable. If it the puzzle in 
+ * the population vector has a lower fitness value, it becomes the new best
+ * puzzle, and the generation in which it was placed there is also stored in
+ * 'best_generation'.
+ *
+ * The best 1% of puzzles from each generation is also stored in a best of
+ * vector. When restarting the population, if the best of puzzles vector is
+ * equal to the population size, then the best of vector is used as the new
+ * population.
+ *
+ * This inner do-while loop continues until the best_fitness is 0, the best
+ * fitness has been stagnant for a set amount of times, or until the maximum
+ * number of allowable generations has been iterated through.
+ *
+ * If the best fitness counter reaches 15 and the best fitness is 2, we
+ * increase maximum number of generations which can pass without change, since
+ * we are only 2 values off, we want to give a little extra time before
+ * restarting.
+ *
+ * When the inner do-while loop concludes the outter loop will check to see if
+ * a solution has been found, or if the maximum number of generations has been
+ * reached. If not, a new populatin is created and the inner loop will begin
+ * again. If so, the best puzzle from all of the generations is the result,
+ * and is printed out for the user if the solve is verbose.
+ *
+ * params:
+ *		result - receives the best puzzle and the generations bred
+ *****************************************************************************/
+void Solver::solveGenetic(SolveResult &result)
+{
+	const Params &params = *_params;
+	initIsland(_island, _problem, params, _rng);
+	Puzzle best_puzzle = _problem.initial_puzzle;
+	vector<Puzzle> best_of_puzzles;
+	int best_generation = -1;
+
+	int restart_ct = 0;
+	int generation = 0;
+	int best_fitness;
+	int best_fitness_ct;
+	int max_best_fitness_ct;
+
+	//timing iterations per second
+	auto start_time = chrono::high_resolution_clock::now();
+	chrono::duration<float> duration = start_time - start_time;
+  	
+	
+
+	do{
+		// get, evaluate and sort a new population
+		if((int)best_of_puzzles.size() == params.POP)
+		{
+			if (params.VERBOSE)
+			{
+				cout << "**********Sarting With Best Of Population - Restart Number: " << restart_ct;
+				cout << "**********" << endl;
+			}
+			swap(_island.population, best_of_puzzles);
+			best_of_puzzles.clear();
+		}
+		else
+		{
+			if (params.VERBOSE)
+			{
+				cout << "**********Sarting With New Population - Restart Number: " << restart_ct;
+				cout << "**********" << endl;
+			}
+			getInitialPop(_island);
+		}
+		fitness(_island);
+
+		// reset solve variables for the new population
+		best_fitness = _island.population[_island.ranking[0]].fitness;
+		best_fitness_ct = 0;
+		_island.mutation_rate = params.START_MUTATE;
+		max_best_fitness_ct = 20;
+		do{
+			start_time = chrono::high_resolution_clock::now();
+
+			// create next generation via mutation or breeding
+			if(params.MUTATE_ONLY_FLAG)
+			{
+				// generate new population using only mutation
+				mutateOnly(_island);
+			}
+			else
+			{
+				// generate new population using breeding
+				breed(_island);
+			}
+			duration += (chrono::high_resolution_clock::now() - start_time);
+
+			// rank and sort population of new generation
+			fitness(_island);
+
+			// keep track of failure to make fitness progress
+			if (best_fitness == _island.population[_island.ranking[0]].fitness)
+			{
+				best_fitness_ct++;
+				
+				// increase mutation rate after 15 stagnant generations, cap mutation rate at 100%
+				if ((best_fitness_ct > 15) && (_island.mutation_rate < 100))
+				{
+					_island.mutation_rate += 5;
+					// if fitness is 2, we're close, so don't restart after 30 give time for more mutations and breeding
+					if (best_fitness == 2)
+					{
+						max_best_fitness_ct = 50;
+					}
+					else
+					{
+						// reset to 20 for cases with pure mutation or without elitism
+						max_best_fitness_ct = 20;
+					}
+				}
+			} 
+			else
+			{
+				// reset the stagnation counter
+				best_fitness_ct = 0;
+				_island.mutation_rate = params.START_MUTATE;
+			}
+
+			// a puzzle stalled close to the answer is usually a swap or two away, so search for them directly
+			if ((best_fitness_ct == ENDGAME_STALL) && (best_fitness <= ENDGAME_FITNESS))
+			{
+				Puzzle &stalled = _island.population[_island.ranking[0]];
+				int before = stalled.fitness;
+				start_time = chrono::high_resolution_clock::now();
+				int evaluated = repairEndgame(_problem, stalled);
+				duration += (chrono::high_resolution_clock::now() - start_time);
+
+				if (params.VERBOSE)
+				{
+					cout << "Endgame repair: fitness " << before << " -> " << stalled.fitness;
+					cout << ", " << evaluated << " moves evaluated" << endl;
+				}
+				if (stalled.fitness < before)
+				{
+					best_fitness_ct = 0;
+					_island.mutation_rate = params.START_MUTATE;
+				}
+			}
+
+			// store best puzzle out of all generations
+			if(_island.population[_island.ranking[0]].fitness <= best_puzzle.fitness)
+			{
+				best_puzzle = _island.population[_island.ranking[0]];
+				best_generation = generation;
+			}
+
+			// track the fitness of the most fit member of the population
+			best_fitness = _island.population[_island.ranking[0]].fitness;
+
+			// store the best 1% of each generation and reset fitness
+			for( int i = 0; i < (params.POP * 0.01); i++)
+			{
+				if((int)best_of_puzzles.size() < params.POP)
+				{
+					best_of_puzzles.push_back(_island.population[_island.ranking[i]]);
+				}
+			}
+
+
+			// display each generation details to the user
+			if (params.VERBOSE)
+			{
+				cout << "Generation"<< right << setw(5)<< generation;
+				cout << ": best score =" << right << setw(3)<< best_fitness;
+				cout << ", worst score =" << right << setw(3)<< _island.population[_island.ranking.back()].fitness << endl;
+			}
+
+			// move on to next generation
+			generation++;
+
+		// stop when a puzzle is solved, when the best fitness is stagnant or when reached max generations
+		} while ((best_fitness != 0) && (best_fitness_ct < max_best_fitness_ct) && (generation < params.GENERATIONS));
+		
+		
+		// if a puzzle hasn't been solved restart the population
+		if(best_fitness != 0){
+			restart_ct++;
+		}
+
+
+	// stop when a puzzle has been solved or when we have reached the maximum number of generations
+	} while ((best_fitness != 0) && (generation < params.GENERATIONS));
+
+	// get duration in millisecond format
+	auto millisec = chrono::duration_cast<chrono::milliseconds>(duration);
+	double iter_per_sec = (generation/(double)millisec.count()) * 1000;
+
+	result.best = best_puzzle;
+	result.solved = (best_puzzle.fitness == 0);
+	result.iterations = generation;
+	if (!params.VERBOSE)
+		return;
+
+	cout << "************Best Solution************" << endl;
+	best_puzzle.print();
+	cout << "Sudoku results: fitness " << best_puzzle.fitness << ", generation "<< best_generation;
+	cout << ", " << millisec.count() << " msec, "<< iter_per_sec << " iter/sec" << endl;
+}
+
+/******************************************************************************
+ * Solver::solveExactly(SolveResult&)
+ *
+ * This function solves the initial puzzle with the exact backtracking search
+ * instead of the genetic algorithm. The search starts from the preprocessed
+ * initial puzzle, so every single already filled is a given to it. The
+ * solution (or the initial puzzle, if there is no solution) is printed with
+ * a result line in the same format as the genetic algorithm's, reporting the
+ * number of values tried (nodes) rather than generations.
+ *
+ * params:
+ *		result - receives the solution and the nodes searched
+ *****************************************************************************/
+void Solver::solveExactly(SolveResult &result)
+{
+	Puzzle solution = _problem.initial_puzzle;
+	long long nodes = 0;
+
+	auto start_time = chrono::high_resolution_clock::now();
+	bool solved = solveExact(solution, nodes);
+	chrono::duration<double, milli> millisec = chrono::high_resolution_clock::now() - start_time;
+
+	double nodes_per_sec = (nodes / millisec.count()) * 1000;
+
+	result.best = solution;
+	result.solved = solved;
+	result.iterations = nodes;
+	if (!_params->VERBOSE)
+		return;
+
+	if (solved)
+	{
+		cout << "************Exact Solution************" << endl;
+	}
+	else
+	{
+		cout << "************No Solution Exists************" << endl;
+	}
+	solution.print();
+	cout << "Sudoku results: fitness " << solution.fitness << ", nodes " << nodes;
+	cout << ", " << millisec.count() << " msec, " << nodes_per_sec << " nodes/sec" << endl;
+}
+
+/******************************************************************************
+ * Solver::solveAnnealing(SolveResult&)
+ *
+ * This function solves the initial puzzle by simulated annealing instead of
+ * the genetic algorithm. To compare the two on the same budget, annealing may
+ * try as many swaps as the genetic algorithm makes children, population size
+ * times generations. The best puzzle found is printed with a result line in
+ * the same format as the genetic algorithm's, reporting the number of swaps
+ * tried (moves) rather than generations.
+ *
+ * params:
+ *		result - receives the best puzzle and the moves tried
+ *****************************************************************************/
+void Solver::solveAnnealing(SolveResult &result)
+{
+	const Params &params = *_params;
+	Puzzle best;
+	Rng anneal_rng(_rng.next());
+	long long max_moves = (long long)params.POP * params.GENERATIONS;
+	long long moves = 0;
+
+	auto start_time = chrono::high_resolution_clock::now();
+	bool solved = solveAnneal(_problem, best, anneal_rng, max_moves, moves);
+	chrono::duration<double, milli> millisec = chrono::high_resolution_clock::now() - start_time;
+
+	double moves_per_sec = (moves / millisec.count()) * 1000;
+
+	result.best = best;
+	result.solved = solved;
+	result.iterations = moves;
+	if (!params.VERBOSE)
+		return;
+
+	if (solved)
+	{
+		cout << "************Annealed Solution************" << endl;
+	}
+	else
+	{
+		cout << "************Best Solution************" << endl;
+	}
+	best.print();
+	cout << "Sudoku results: fitness " << best.fitness << ", moves " << moves;
+	cout << ", " << millisec.count() << " msec, " << moves_per_sec << " moves/sec" << endl;
+}
+
+/******************************************************************************
+ * Solver::solveIslands(SolveResult&)
+ *
+ * This function solves the initial puzzle with the island model, evolving
+ * several populations at once rather than restarting a single one. The best
+ * puzzle found by any island is printed with a result line in the same
+ * format as a single population run. The timing covers the whole run, and
+ * iter/sec counts the generations bred by every island together.
+ *
+ * When this process is one island in a ring of processes, linked by shared
+ * memory or by sockets, only its own island is evolved here and only its own
+ * best puzzle is printed. The process that solves the puzzle prints the
+ * solution.
+ *
+ * params:
+ *		result - receives the best puzzle and the generations bred
+ *****************************************************************************/
+void Solver::solveIslands(SolveResult &result)
+{
+	const Params &params = *_params;
+	Puzzle best;
+	int best_generation = 0;
+	long long generations = 0;
+
+	auto start_time = chrono::high_resolution_clock::now();
+	if (!params.SHM_NAME.empty())
+	{
+		ShmChannel channel;
+		if (!channel.open(params.SHM_NAME, params.RANK, params.RANKS, _problem, result.error))
+		{
+			return;
+		}
+		generations = runLinkedIsland(_problem, params, _rng, channel, params.RANK, best, best_generation);
+	}
+	else if (!params.LISTEN.empty())
+	{
+		SocketChannel channel;
+		if (!channel.open(params.LISTEN, params.CONNECT, _problem, result.error))
+		{
+			return;
+		}
+		generations = runLinkedIsland(_problem, params, _rng, channel, params.RANK, best, best_generation);
+	}
+	else
+	{
+		generations = runIslands(_problem, params, _rng, best, best_generation);
+	}
+	auto millisec = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start_time);
+	double iter_per_sec = (generations / (double)millisec.count()) * 1000;
+
+	result.best = best;
+	result.solved = (best.fitness == 0);
+	result.iterations = generations;
+	if (!params.VERBOSE)
+		return;
+
+	cout << "************Best Solution************" << endl;
+	best.print();
+	cout << "Sudoku results: fitness " << best.fitness << ", generation " << best_generation;
+	cout << ", " << millisec.count() << " msec, " << iter_per_sec << " iter/sec" << endl;
+}
+
+/******************************************************************************
+ * readPuzzle(istream&, Puzzle&, string&)
+ *
+ * This function reads one puzzle from a stream of characters, ignoring
+ * white space. Each character is used as the value of the next square of
+ * the puzzle, and a '-' character leaves the square blank.
+ *
+ * Exactly as many characters as the board has squares are read, so several
+ * puzzles can follow one another in the same stream. The board order is
+ * fixed when the program is built, so a symbol that is not a value on this
+ * size of board, or a stream that ends part way through a puzzle, is
+ * rejected.
+ *
+ * params:
+ *			in - the stream to read the puzzle from
+ *		puzzle - receives the squares of the puzzle
+ *		 error - receives what was wrong with the puzzle, or is left empty
+ *				 if the stream held no more puzzles
+ *
+ * returns: true if a whole puzzle was read in
+ *****************************************************************************/
+bool readPuzzle(istream &in, Puzzle &puzzle, string &error)
+{
+	char value;
+	int i = 0;
+	error.clear();
+
+	// read in characters ignoring white space
+	while (i < BOARD_SQUARES && in >> value)
+	{
+		int index = valueIndex(value);
+		if (value != '-' && (index < 0 || index >= BOARD_DIM))
+		{
+			error = "Invalid symbol '" + string(1, value) + "' for a " + to_string(BOARD_DIM) + "x" + to_string(BOARD_DIM) + " puzzle.";
+			return false;
+		}
+
+		// insert into puzzle
+		puzzle.setValue(i, value);
+		i++;
+	}
+
+	// the puzzle must fill the board this program was built for
+	if (i != BOARD_SQUARES)
+	{
+		if (i > 0)
+		{
+			error = "Read " + to_string(i) + " squares, but this program solves " + to_string(BOARD_DIM) + "x" + to_string(BOARD_DIM);
+			error += " puzzles (" + to_string(BOARD_SQUARES) + " squares).";
+		}
+		return false;
+	}
+	return true;
+}
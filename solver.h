@@ -0,0 +1,63 @@
+ /************************************************************************
+   File: solver.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Header file for the Solver class, which solves one puzzle
+   from start to finish: preprocessing, then whichever engine the params
+   choose. A solver owns all of the state of a solve, the problem context,
+   the initial puzzle, the population and its breeding scratch space and
+   the random generator, and only reads the params it is given. Solvers
+   share nothing, so any number of them can solve puzzles at once.
+
+   Usage: Fill a Puzzle with setValue(), leaving blank squares as '-' (or
+   read one in with readPuzzle()), set up a Params and call solve(). A
+   solver may be reused for any number of puzzles one after another, and
+   keeps its population's memory between them. Build with the library
+   target (make libsudoku.a) and link it into another program to embed
+   the solver.
+ ************************************************************************/
+#ifndef __SOLVER_H_
+#define __SOLVER_H_
+
+#include "globals.h"
+
+/******************************************************************************
+ * SolveResult
+ * What solving one puzzle found. The iterations are generations for the
+ * genetic algorithm, values tried (nodes) for the exact search and swaps
+ * tried (moves) for simulated annealing.
+ *****************************************************************************/
+struct SolveResult
+{
+	Puzzle best; //the solution, or the best puzzle found
+	bool solved = false; //true if best is a solution
+	bool preprocessed = false; //true if preprocessing alone solved the puzzle
+	int singles = 0; //singles filled in by preprocessing
+	long long iterations = 0; //generations, nodes or moves the engine ran for
+	double msec = 0; //time taken, preprocessing included
+	string error = ""; //why the puzzle could not be solved at all, empty if it was tried
+};
+
+class Solver
+{
+	public:
+		// Constructors
+		Solver();
+
+		// Others
+		SolveResult solve(const Puzzle&, const Params&); //solve a puzzle with the given params
+
+	private:
+		const Params *_params; //params of the solve in progress
+		ProblemContext _problem; //the puzzle being solved
+		Island _island; //the population of a single population run
+		Rng _rng; //generator every random number of the solve is drawn from
+
+		void solveGenetic(SolveResult&); //breed a single population
+		void solveExactly(SolveResult&); //backtracking search
+		void solveAnnealing(SolveResult&); //simulated annealing
+		void solveIslands(SolveResult&); //island model, on threads or processes
+};
+
+bool readPuzzle(istream&, Puzzle&, string&);
+
+#endif
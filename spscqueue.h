@@ -0,0 +1,111 @@
+ /************************************************************************
+   File: spscqueue.h
+   Authors: Katie MacMillan, Jake Davidson
+   Description: Header file for the SpscQueue class, a bounded lock free
+   queue for exactly one producer thread and one consumer thread. The
+   producer only writes the tail and the consumer only writes the head,
+   so neither ever waits on a lock. Islands use these queues to pass
+   migrants around the ring without a global barrier.
+
+   Usage: Size the queue with reserve() before either thread uses it.
+   The producer calls push() and the consumer calls pop(); both return
+   false rather than blocking when the queue is full or empty. The
+   functions are defined here since the class is a template.
+ ************************************************************************/
+#ifndef __SPSC_QUEUE_H_
+#define __SPSC_QUEUE_H_
+
+#include <atomic>
+#include <vector>
+#include <stddef.h>
+
+template <class T>
+class SpscQueue
+{
+	public:
+		// Constructors
+		SpscQueue() : _mask(0), _head(0), _tail(0) {}
+
+		// Setters
+		void reserve(size_t); //size the queue to hold at least n items
+
+		// Others
+		bool push(const T&); //add an item, false if the queue is full
+		bool pop(T&); //remove the oldest item, false if the queue is empty
+
+	private:
+		std::vector<T> _slots; //ring buffer, its size is a power of two
+		size_t _mask; //slot count minus one
+		std::atomic<size_t> _head; //next slot to read, only written by the consumer
+		char _pad[64]; //keeps the head and tail on different cache lines
+		std::atomic<size_t> _tail; //next slot to write, only written by the producer
+};
+
+/******************************************************************
+ * reserve(size_t n)
+ * Size the queue to hold at least n items. The slot count is rounded
+ * up to a power of two so positions wrap with a mask. Must not be
+ * called while either thread is using the queue.
+ *
+ * params:
+ *			n - the number of items the queue must hold
+ *****************************************************************/
+template <class T>
+void SpscQueue<T>::reserve(size_t n)
+{
+	size_t size = 1;
+	while (size < n)
+	{
+		size <<= 1;
+	}
+	_slots.resize(size);
+	_mask = size - 1;
+	_head.store(0);
+	_tail.store(0);
+}
+
+/******************************************************************
+ * push(const T &item)
+ * Add an item to the back of the queue. The item is copied into its
+ * slot before the tail is published, so the consumer never sees a
+ * slot that is still being written.
+ *
+ * params:
+ *			item - the item to add
+ * returns: true if the item was added, false if the queue was full
+ *****************************************************************/
+template <class T>
+bool SpscQueue<T>::push(const T &item)
+{
+	size_t tail = _tail.load(std::memory_order_relaxed);
+	if (tail - _head.load(std::memory_order_acquire) == _slots.size())
+		return false;
+
+	_slots[tail & _mask] = item;
+	_tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+/******************************************************************
+ * pop(T &item)
+ * Remove the item at the front of the queue. The slot is copied out
+ * before the head is published, so the producer never overwrites a
+ * slot that is still being read.
+ *
+ * params:
+ *			item - receives the removed item
+ * returns: true if an item was removed, false if the queue was empty
+ *****************************************************************/
+template <class T>
+bool SpscQueue<T>::pop(T &item)
+{
+	size_t head = _head.load(std::memory_order_relaxed);
+	if (head == _tail.load(std::memory_order_acquire))
+		return false;
+
+	item = _slots[head & _mask];
+	_head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+#endif
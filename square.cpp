@@ -15,7 +15,8 @@
  * since there is no value yet, and sets preset to false.
  *****************************************************************/
 square::square(){
-	_possible.resize(9, true);
+	_value = '-';
+	_possible = (mask_type)((1u << BOARD_DIM) - 1);
 	preset = false;
 }
 
@@ -35,7 +36,7 @@ square::square(char val, int dim, bool pre) {
 	_value = val;
 	//fill possible values list with either true or false
 	//if the square is blank, all values are possible
-	_possible.resize(dim, (_value == '-'));
+	_possible = (_value == '-') ? (mask_type)((1u << dim) - 1) : 0;
 	preset = pre;
 }
 
@@ -52,15 +53,19 @@ square::square(char val, int dim, bool pre) {
  *****************************************************************/
 int square::getPossibleCt()
 {
-	int count = 0;
-	// count the remaining true flags in the possible array
-	for (int i = 0; i < 9; i++){
-		if (_possible[i]){
-			count++;
-		}
-	}
-	return count;
+	// count the remaining set bits in the possible mask
+	return __builtin_popcount(_possible);
+}
 
+/******************************************************************
+ * getPossible
+ * get the bitmask of possible values for the square
+ *
+ * returns: the possible mask, bit i set if value index i is possible
+ *****************************************************************/
+square::mask_type square::getPossible()
+{
+	return _possible;
 }
 
 /******************************************************************
@@ -72,11 +77,9 @@ int square::getPossibleCt()
 vector<char> square::getPossibleValues()
 {
 	vector<char> values;
-	// add positions with a true flag to a value vector
-	for (int i = 0; i < 9; i++){
-		if (_possible[i]){
-			values.push_back((char)(i+1));
-		}
+	// add positions with a set bit to a value vector
+	for (mask_type m = _possible; m != 0; m &= m - 1){
+		values.push_back(valueSymbol(__builtin_ctz(m)));
 	}
 	return values;
 }
@@ -92,9 +95,9 @@ vector<char> square::getPossibleValues()
  *****************************************************************/
 bool square::isPossibleValue(char val)
 {
-	//fancy trick to convert char to int index
-	int i = val - '1';
-	return _possible[i];
+	//convert symbol to int index
+	int i = valueIndex(val);
+	return (_possible >> i) & 1;
 }
 
 /******************************************************************
@@ -132,10 +135,8 @@ void square::setValue(char val)
  *****************************************************************/
 void square::setValue(int num)
 {
-	// convert number to string
-	string val = to_string(num);
-	// set value to character
-	_value = val[0];
+	// convert number to its symbol, numbers above 9 become letters
+	_value = valueSymbol(num - 1);
 }
 
 /******************************************************************
@@ -147,9 +148,9 @@ void square::setValue(int num)
  *****************************************************************/
 void square::togglePossible(char val)
 {
-	// convert value to int and decrement to find possition in array
-	int num = atoi((const char*) &val)-1;
-	_possible[num] = false;
+	// convert value to its index to find possition in mask
+	int num = valueIndex(val);
+	_possible &= ~(1u << num);
 }
 
 /******************************************************************
@@ -158,15 +159,11 @@ void square::togglePossible(char val)
  *****************************************************************/
 void square::setSingle()
 {
-	for (int i = 0; i < 9; i++){
-		// find first index with the value 'true'
-		if (_possible[i]){
-			int num = i+1;
-			// convert to string
-			string val = to_string(num);
-			// set as character
-			_value = val[0];
-		}
+	// find first set bit in the possible mask
+	if (_possible != 0){
+		int num = __builtin_ctz(_possible);
+		// set as the value's symbol
+		_value = valueSymbol(num);
 	}
 	preset = true;
 }
@@ -191,10 +188,8 @@ void square::setSingle(char val)
  * used for debugging purposes
  *****************************************************************/
 void square::printPossible(){
-	for(int i = 0; i < 9; i++){
-		if(_possible[i]){
-			cout << i+1 << ":" << _possible[i] << " ";
-		}
+	for(mask_type m = _possible; m != 0; m &= m - 1){
+		cout << valueSymbol(__builtin_ctz(m)) << ":" << 1 << " ";
 	}
 	cout << endl;
 }
\ No newline at end of file
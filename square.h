@@ -12,6 +12,10 @@
    and whether or not it is a preset square. Once created, you can use the 
    set and toggle functions to modify the possible values if you are solving 
    for hidden and naked singles.
+
+   The possible values are stored inline as a bitmask (bit i set means the
+   value with index i is possible), so a square is a small, trivially copyable value and 
+   copying a puzzle does not allocate per square.
  ************************************************************************/
 #ifndef __SQUARE_H_
 #define __SQUARE_H_
@@ -21,12 +25,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <vector>
+#include <stdint.h>
+#include <type_traits>
+#include "boardorder.h"
 
 using namespace std;
 
 class square
 {
 	public:
+		//bitmask of possible values, bit i is value index i. 25x25 boards need 32 bits
+		typedef std::conditional<(BOARD_DIM <= 16), uint16_t, uint32_t>::type mask_type;
+
 		bool preset; //flag for if this square is 'set in stone' from the init puzzle config or through hidden/naked singles
 		// Constructors
 		square(); //default
@@ -34,6 +44,7 @@ class square
 
 		// Getters
 		int getPossibleCt(); //get the number of possible squares
+		mask_type getPossible(); //get the bitmask of possible values
 		char getValue(); //get the value of the square
 		vector<char> getPossibleValues(); //get the possible values
 
@@ -51,7 +62,7 @@ class square
 
 	private:
 		char _value;				// value at possition
-		vector<bool> _possible;			// which values are possible for this square
+		mask_type _possible;			// which values are possible for this square
 };
 
 #endif
\ No newline at end of file
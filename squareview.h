@@ -0,0 +1,43 @@
+ /************************************************************************
+   File: squareview.h
+   Authors: Katie MacMillian, Jake Davidson
+   Description: Header file for the square view class. A square view is a
+   light weight window onto squares stored somewhere else (usually inside a
+   puzzle). It does not own or copy any squares, so rows, columns and
+   subgrids can be walked and modified in place without building temporary
+   vectors.
+
+   Usage: A view is described by a start index and a strided walk. Every
+   _run squares the walk jumps ahead _skip squares from the start of the
+   previous run. A row is one run of dim squares, a column is dim runs of one
+   square, and a subgrid is sub_dim runs of sub_dim squares. Indexing a view
+   returns a reference, so assigning through it writes into the puzzle.
+ ************************************************************************/
+#ifndef __SQUARE_VIEW_H_
+#define __SQUARE_VIEW_H_
+
+#include "square.h"
+
+class SquareView
+{
+	public:
+		// Constructors
+		SquareView(square* base, int start, int run, int skip, int len)
+			: _base(base), _start(start), _run(run), _skip(skip), _len(len) {}
+
+		// Getters
+		int size() const { return _len; } //number of squares in the view
+		int index(int i) const { return _start + (i / _run) * _skip + (i % _run); } //1D puzzle position of the i'th square
+
+		//overloaded operators
+		square & operator [] (int i) const { return _base[index(i)]; } //access a square in the view
+
+	private:
+		square* _base; //first square of the underlying storage
+		int _start; //position of the first square in the view
+		int _run; //number of contiguous squares before jumping
+		int _skip; //distance between the starts of two runs
+		int _len; //total number of squares in the view
+};
+
+#endif
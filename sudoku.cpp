@@ -27,321 +27,77 @@
    		  generations, selection, and mutation values
    Output: Either the solution to the puzzle or the best guess we got after max
    		   generations have been reached
-   Compilation instructions: make
+   Compilation instructions: make (make sudoku4, sudoku16 or sudoku25 to build
+   		  the solver for 4x4, 16x16 or 25x25 puzzles)
    Usage: ./sudoku filename population generations selection mutation
+   		  (add --batch N to solve a file or directory of puzzles)
  ************************************************************************/
 #include "globals.h"
-#include "preprocess.h"
-#include "population.h"
-#include "puzzle.h"
-#include "breed.h"
+#include "solver.h"
+#include "batch.h"
+#include "islands.h"
 #include <string>
 using namespace std;
 
-// "constant" data for the puzzle
-ConstData const_data;
+// "constant" data for the puzzle, set from the command line
+static Params params;
 
-// program globals
-int mutation_rate;
-vector<Puzzle> population;
-vector<Puzzle> new_generation;
-vector<Puzzle> breeding_pool;
-Puzzle initial_puzzle(9);
-
-void solve();
-void handleFlags(int, char*[]);
+string handleFlags(int, char*[], Puzzle&);
+void handleOption(string, char*);
 double tryParse(string, double);
-bool readInPuzzle(char*);
+bool readInPuzzle(char*, Puzzle&);
 void printUsage();
 void printStartParams(char*, double);
-void evaluatePresetCounts();
 
 /******************************************************************************
  * main()
  *
- * This is the main entry point to the sudoku program. It begins by seeding
- * a random number generator, and then handles commandline arguments entered
- * by the user. When this is completed and the initial puzzle has been read
- * in, the function will enter a do-while loop which will look for naked and
- * hidden singles within the puzzle. 
- *
- * Both the function to find naked and hidden singles will return a boolean
- * value indicating whether or not a single was filled during the execution
- * of the function. The do-while loop will continue to look for singles until
- * both return without having filled any singles.
+ * This is the main entry point to the sudoku program. It begins by handling
+ * commandline arguments entered by the user, which reads in the initial
+ * puzzle. The puzzle is then solved by a Solver, seeded from the master
+ * random seed, which prints the puzzle once its singles have been filled
+ * in, the progress of the chosen engine and the best puzzle it found.
  *
- * When all singles have been filled in, the fitness of the puzzle is
- * evaluated. If the fitness of the puzzle is 0, it means that the puzzle is
- * completed and we are done. Otherwise the function moves goes into the solve
- * function.
+ * In batch mode the file or directory named on the command line is solved
+ * a puzzle at a time by a pool of worker threads instead, printing a line
+ * for each puzzle and totals for the whole batch.
  *
  * params:
- *			argc - 
- *			argv - 
+ *			argc - the number of command line arguments
+ *			argv - the command line argument strings
  *
  * returns:
  *****************************************************************************/
 int main(int argc, char* argv[])
 {
+	Puzzle puzzle;
 
-	//init random number generator
-	srand(static_cast <unsigned int> (time(0)));
+	// default to a time based seed, which may be overridden with --seed
+	params.SEED = static_cast <uint64_t> (time(0));
 
 	// take input flags and set program constant variable data
-	handleFlags(argc, argv);
+	string path = handleFlags(argc, argv, puzzle);
 
-	// print original puzzle
-	cout << "********Initial Configuration (9x9 grid)********" << endl;
-	initial_puzzle.print(false);
-
-	bool found1;
-	bool found2;
-	// fill singles of start puzzle until there is no change
-	do
+	if (params.BATCH >= 0)
 	{
-		found1 = fillNakedSingles();
-		found2 = fillHiddenSingles();
-
-	} while (found1 || found2);
-
-	cout << "********Filled In Predetermined Singles********" << endl;
-	initial_puzzle.print(false);
-
-	// evaluate puzzle to see if it is already solved
-	initial_puzzle.evaluateFitness();
-	
-
-	// fill population and new_generation, this is to avoid pushbacks and rebuilding vectors
-	for(int i = 0; i < const_data.POP; i++)
-	{
-		population.push_back(initial_puzzle);
-		new_generation.push_back(initial_puzzle);
-
-		if (i < const_data.BREEDERS){
-			breeding_pool.push_back(initial_puzzle);
-		}
+		runBatch(path, params);
+		return 1;
 	}
 
-	evaluatePresetCounts();
-
-	// check if puzzle is done
-	if(initial_puzzle.fitness != 0)
-	{
-		solve();
-	}
-	else
+	// solve the puzzle, printing as we go
+	params.VERBOSE = true;
+	Solver solver;
+	SolveResult result = solver.solve(puzzle, params);
+	if (!result.error.empty())
 	{
-		cout << "**********Puzzle Complete After Filling Singles**********" << endl;
-		initial_puzzle.print();
+		cout << result.error << "  Exiting program..." << endl;
+		exit(-1);
 	}
-	
 	return 1;
 }
 
-
-/******************************************************************************
- * solve()
- *
- * This function executes the nested do loops in an attempt to solve the 
- * initial puzzle. The best puzzle found during the course of running is saved
- * in a Puzzle variable called 'best_puzzle'. It initially begins as the
- * inital puzzle.
- *
- * The outter do-while loop begins by creating a new population, assessing the
- * fittness of each puzzle in the population, and then sorting the population
- * in ascending order based on fitness. When this is done a handful of
- * variables are reset to their starting positions to begin the breeding phase
- * for the newly generated population.
- *
- * During the inner do-while loop the breeding phase occurs. In this loop the
- * population is either breed, or mutated to create subsequent generations.
- * The 'population' vector is replaced with the new generation, and then each
- * puzzle in has its fitness assesed, and then the population is sorted based
- * on fitness.
- * 
- * After sorting the population the fitness of the first puzzle in the 
- * population is compared to the value stored in 'best_fitness'. If both
- * values are the same, the best_fitness_ct is incremented. This is to indicate
- * how many generations have passed without a changing top puzzle fitness.
- *
- * If the best_fitness_ct counter reaches 15, it indicates a significant level
- * of stagnation. In these cases the program begins to increase the mutation
- * rate by 5% for each subsequent generation with the same best fitness value.
- * The mutation rate does not, however, exceed 100%.
- *
- * When the first puzzle's fitness is not the same as the 'best_fitness', the
- * counter is reset to 0, and the mutation rate is set back to the original
- * starting mutation rate.
- * 
- * When this is done the fitness of the best puzzle in the new
- * generation, now stored in the population vector, is compared to the fitness
- * of the puzzle stored in the 'best_puzzle' variable. If it the puzzle in 
- * the population vector has a lower fitness value, it becomes the new best
- * puzzle, and the generation in which it was placed there is also stored in
- * 'best_generation'.
- *
- * The best 1% of puzzles from each generation is also stored in a best of
- * vector. When restarting the population, if the best of puzzles vector is
- * equal to the population size, then the best of vector is used as the new
- * population.
- *
- * This inner do-while loop continues until the best_fitness is 0, the best
- * fitness has been stagnant for a set amount of times, or until the maximum
- * number of allowable generations has been iterated through.
- *
- * If the best fitness counter reaches 15 and the best fitness is 2, we
- * increase maximum number of generations which can pass without change, since
- * we are only 2 values off, we want to give a little extra time before
- * restarting.
- *
- * When the inner do-while loop concludes the outter loop will check to see if
- * a solution has been found, or if the maximum number of generations has been
- * reached. If not, a new populatin is created and the inner loop will begin
- * again. If so, the best puzzle from all of the generations is printed out
- * for the user.
- *****************************************************************************/
-void solve()
-{
-	Puzzle best_puzzle = initial_puzzle;
-	vector<Puzzle> best_of_puzzles;
-	int best_generation = -1;
-
-	int restart_ct = 0;
-	int generation = 0;
-	int best_fitness;
-	int best_fitness_ct;
-	int max_best_fitness_ct;
-	auto fitness_time = chrono::high_resolution_clock::now();
-
-	//timing iterations per second
-	auto start_time = chrono::high_resolution_clock::now();
-	chrono::duration<float> duration = start_time - start_time;
-  	
-	
-
-	do{
-		// get, evaluate and sort a new population
-		if(best_of_puzzles.size() == const_data.POP)
-		{
-			cout << "**********Sarting With Best Of Population - Restart Number: " << restart_ct;
-			cout << "**********" << endl;
-			swap(population, best_of_puzzles);
-			best_of_puzzles.clear();
-		}
-		else
-		{
-			cout << "**********Sarting With New Population - Restart Number: " << restart_ct;
-			cout << "**********" << endl;
-			getInitialPop();
-		}
-		fitness();
-
-		// reset solve variables for the new population
-		best_fitness = population[0].fitness;
-		best_fitness_ct = 0;
-		mutation_rate = const_data.START_MUTATE;
-		max_best_fitness_ct = 20;
-		do{
-			start_time = chrono::high_resolution_clock::now();
-
-			// create next generation via mutation or breeding
-			if(const_data.MUTATE_ONLY_FLAG)
-			{
-				// generate new population using only mutation
-				mutateOnly();
-			}
-			else
-			{
-				// generate new population using breeding
-				breed();
-			}
-			duration += (chrono::high_resolution_clock::now() - start_time);
-
-			// rank and sort population of new generation
-			fitness();
-
-			// keep track of failure to make fitness progress
-			if (best_fitness == population[0].fitness)
-			{
-				best_fitness_ct++;
-				
-				// increase mutation rate after 15 stagnant generations, cap mutation rate at 100%
-				if ((best_fitness_ct > 15) && (mutation_rate < 100))
-				{
-					mutation_rate += 5;
-					// if fitness is 2, we're close, so don't restart after 30 give time for more mutations and breeding
-					if (best_fitness == 2)
-					{
-						max_best_fitness_ct = 50;
-					}
-					else
-					{
-						// reset to 20 for cases with pure mutation or without elitism
-						max_best_fitness_ct = 20;
-					}
-				}
-			} 
-			else
-			{
-				// reset the stagnation counter
-				best_fitness_ct = 0;
-				mutation_rate = const_data.START_MUTATE;
-			}
-
-			// store best puzzle out of all generations
-			if(population[0].fitness <= best_puzzle.fitness)
-			{
-				best_puzzle = population[0];
-				best_generation = generation;
-			}
-
-			// track the fitness of the most fit member of the population
-			best_fitness = population[0].fitness;
-
-			// store the best 1% of each generation and reset fitness
-			for( int i = 0; i < (const_data.POP * 0.01); i++)
-			{
-				if(best_of_puzzles.size() < const_data.POP)
-				{
-					best_of_puzzles.push_back(population[i]);
-				}
-			}
-
-
-			// display each generation details to the user
-			 cout << "Generation"<< right << setw(5)<< generation;
-			 cout << ": best score =" << right << setw(3)<< best_fitness;
-			 cout << ", worst score =" << right << setw(3)<< population.back().fitness << endl;
-
-			// move on to next generation
-			generation++;
-
-		// stop when a puzzle is solved, when the best fitness is stagnant or when reached max generations
-		} while ((best_fitness != 0) && (best_fitness_ct < max_best_fitness_ct) && (generation < const_data.GENERATIONS));
-		
-		
-		// if a puzzle hasn't been solved restart the population
-		if(best_fitness != 0){
-			restart_ct++;
-		}
-
-
-	// stop when a puzzle has been solved or when we have reached the maximum number of generations
-	} while ((best_fitness != 0) && (generation < const_data.GENERATIONS));
-		// get duration in millisecond format
-
-		auto millisec = chrono::duration_cast<chrono::milliseconds>(duration);
-		double iter_per_sec = (generation/(double)millisec.count()) * 1000;
-
-		cout << "************Best Solution************" << endl;
-		best_puzzle.print();
-		cout << "Sudoku results: fitness " << best_puzzle.fitness << ", generation "<< best_generation;
-		cout << ", " << millisec.count() << " msec, "<< iter_per_sec << " iter/sec" << endl;
-
-}
-
 /******************************************************************************
- * handleFlags(int, char*)
+ * handleFlags(int, char*, Puzzle&)
  *
  * This function uses the commandline arguments to retrieve user specified run
  * parameters. A switch statement is used to determine what needs to be parsed
@@ -354,14 +110,43 @@ void solve()
  * with and parsed. Allowing the cases to fall through reduces repeated code
  * for things that must be parsed in multiple cases.
  *
+ * Named options of the form "--name value" may appear anywhere on the command
+ * line. They are handled by handleOption and removed before the positional
+ * arguments are counted.
+ *
+ * The puzzle file is read in here, so a bad puzzle is reported before
+ * anything else is printed. In batch mode the file name may be a file of
+ * several puzzles or a directory, and is read in later by the batch.
+ *
  * params:
  *			argc - the number of command line arguments
  *			argv - a pointer of character arrays containing the command line
  *				   argument strings
+ *		  puzzle - receives the puzzle read in, unless in batch mode
+ *
+ * returns: the puzzle file name
  *****************************************************************************/
-void handleFlags(int argc, char* argv[])
+string handleFlags(int argc, char* argv[], Puzzle &puzzle)
 {
 	double selection = 0.4;
+
+	// pull out named options, leaving the positional arguments in order
+	vector<char*> args;
+	for (int i = 0; i < argc; i++)
+	{
+		string arg(argv[i]);
+		if (arg.compare(0, 2, "--") == 0 && (i + 1) < argc)
+		{
+			handleOption(arg.substr(2), argv[++i]);
+		}
+		else
+		{
+			args.push_back(argv[i]);
+		}
+	}
+	argc = args.size();
+	argv = args.data();
+
 	// check for valid number of arguments
 	if (argc < 2 || argc > 7)
 	{
@@ -370,14 +155,14 @@ void handleFlags(int argc, char* argv[])
 	}
 	//check for correct file extension
 	string filename(argv[1]);
-	string extension = filename.substr(filename.length() - 4, filename.length());
-	if (extension.compare(".txt") != 0)
+	string extension = (filename.length() < 4) ? "" : filename.substr(filename.length() - 4, filename.length());
+	if (params.BATCH < 0 && extension.compare(".txt") != 0)
 	{
 		cout << "Please provide a .txt file" << endl;
 		exit(-1);
 	}
 	//read in puzzle from supplied file
-	if(!readInPuzzle(argv[1]))
+	if(params.BATCH < 0 && !readInPuzzle(argv[1], puzzle))
 	{
 		exit(-1);
 	}
@@ -387,23 +172,27 @@ void handleFlags(int argc, char* argv[])
 	{
 		// let cases fall through, higher counts will also parse elements of lower counts
 		case 7: // all options entered
-			const_data.ELITISM_FLAG = tryParse(argv[5], 1);
+			params.ELITISM_FLAG = tryParse(argv[5], 1);
+			// fall through
 		case 6: // mutation rate, population, generations, and selection
-			const_data.START_MUTATE = (tryParse(argv[5], 0.05)) * 100;
+			params.START_MUTATE = (tryParse(argv[5], 0.05)) * 100;
+			// fall through
 		case 5: // population, generations, and selection
 			selection = tryParse(argv[4], 0.4);
+			// fall through
 		case 4: // generations, and selection
-			const_data.GENERATIONS = tryParse(argv[3], 1000);
+			params.GENERATIONS = tryParse(argv[3], 1000);
+			// fall through
 		case 3: // specified population
-			const_data.POP = tryParse(argv[2], 100);
+			params.POP = tryParse(argv[2], 100);
 		// case 2 is all defaults
 		// case 1 is invalid
 	}
 
 	// if negative mutation rate, solve using mutation only with population selection
-	if (const_data.START_MUTATE < 0)
+	if (params.START_MUTATE < 0)
 	{
-		const_data.MUTATE_ONLY_FLAG = true;
+		params.MUTATE_ONLY_FLAG = true;
 	}
 
 	// don't select more than 100% of the population for breeding or less than 0
@@ -417,16 +206,162 @@ void handleFlags(int argc, char* argv[])
 	}
 
 	// number of breeders to produce next generation
-	const_data.BREEDERS = const_data.POP * selection;
-	if (const_data.BREEDERS < const_data.POP / 2)
+	params.BREEDERS = params.POP * selection;
+	if (params.BREEDERS < params.POP / 2)
 	{
 		// number of breeders to keep in next generation
-		const_data.ELITE = (const_data.POP - (const_data.BREEDERS * 2)) * 0.9;
+		params.ELITE = (params.POP - (params.BREEDERS * 2)) * 0.9;
 		// number of lucky, non-fit population to keep in next generation
-		const_data.LUCKY = const_data.POP - (const_data.BREEDERS* 2) - const_data.ELITE;
+		params.LUCKY = params.POP - (params.BREEDERS* 2) - params.ELITE;
+	}
+
+	// an island process links to its neighbours one way, and evolves one island
+	bool linked = !params.SHM_NAME.empty() || !params.LISTEN.empty();
+	if ((params.LISTEN.empty() != params.CONNECT.empty()) ||
+		(!params.SHM_NAME.empty() && !params.LISTEN.empty()) ||
+		(linked && params.ISLANDS > 1))
+	{
+		cout << "\nAn island process needs either --shm or both --listen and --connect, without --islands" << endl;
+		printUsage();
+		exit(-1);
+	}
+
+	// the batch's workers already keep every core busy, one puzzle each
+	if (params.BATCH >= 0 && (linked || params.ISLANDS > 1))
+	{
+		cout << "\nBatch mode solves each puzzle with a single population, without --islands or island processes" << endl;
+		printUsage();
+		exit(-1);
 	}
 
 	printStartParams(argv[1], selection);
+	return filename;
+}
+
+/******************************************************************************
+ * handleOption(string, char*)
+ *
+ * This function handles a single named command line option. An unknown
+ * option prints the usage and exits.
+ *
+ * params:
+ *			name - the option name, without the leading "--"
+ *			value - the option's value
+ *****************************************************************************/
+void handleOption(string name, char* value)
+{
+	if (name == "seed")
+	{
+		// random seed, so a run can be repeated exactly
+		params.SEED = strtoull(value, NULL, 10);
+	}
+	else if (name == "engine")
+	{
+		// which solver to run on the preprocessed puzzle
+		string engine(value);
+		if (engine == "ga")
+			params.ENGINE = 0;
+		else if (engine == "exact")
+			params.ENGINE = 1;
+		else if (engine == "anneal")
+			params.ENGINE = 2;
+		else
+		{
+			cout << "\nUnknown engine " << engine << endl;
+			printUsage();
+			exit(-1);
+		}
+	}
+	else if (name == "local-search")
+	{
+		// swaps tried on each child before it joins the new generation
+		params.LOCAL_SEARCH = atoi(value);
+		if (params.LOCAL_SEARCH < 0)
+		{
+			cout << "\nLocal search budget must not be negative" << endl;
+			printUsage();
+			exit(-1);
+		}
+	}
+	else if (name == "islands" || name == "migration")
+	{
+		// island count, or generations between migrations
+		int count = atoi(value);
+		if (count < 1)
+		{
+			cout << "\n--" << name << " must be at least 1" << endl;
+			printUsage();
+			exit(-1);
+		}
+		if (name == "islands")
+			params.ISLANDS = count;
+		else
+			params.MIGRATION = count;
+	}
+	else if (name == "rank" || name == "ranks")
+	{
+		// position in, or size of, a ring of island processes
+		int count = atoi(value);
+		if (count < 0 || (name == "ranks" && count < 2))
+		{
+			cout << "\n--" << name << " is out of range" << endl;
+			printUsage();
+			exit(-1);
+		}
+		if (name == "rank")
+			params.RANK = count;
+		else
+			params.RANKS = count;
+	}
+	else if (name == "shm")
+	{
+		// shared memory segment linking island processes on this machine
+		params.SHM_NAME = value;
+	}
+	else if (name == "listen")
+	{
+		// address the process before this one connects to
+		params.LISTEN = value;
+	}
+	else if (name == "connect")
+	{
+		// address of the next process in the ring
+		params.CONNECT = value;
+	}
+	else if (name == "batch")
+	{
+		// worker threads solving every puzzle in a file or directory
+		params.BATCH = atoi(value);
+		if (params.BATCH < 0)
+		{
+			cout << "\nBatch thread count must not be negative" << endl;
+			printUsage();
+			exit(-1);
+		}
+	}
+	else if (name == "preprocess")
+	{
+		// how much of the puzzle to solve by logic before the GA starts
+		string level(value);
+		if (level == "none")
+			params.PREPROCESS = 0;
+		else if (level == "singles")
+			params.PREPROCESS = 1;
+		else if (level == "all")
+			params.PREPROCESS = 2;
+		else
+		{
+			cout << "\nUnknown preprocessing level " << level << endl;
+			printUsage();
+			exit(-1);
+		}
+	}
+	else
+	{
+		cout << "\nUnknown option --" << name << endl;
+		printUsage();
+		exit(-1);
+	}
 }
 
 /******************************************************************************
@@ -457,25 +392,28 @@ double tryParse(string s, double d)
 }
 
 /******************************************************************************
- * readInPuzzle(char*)
+ * readInPuzzle(char*, Puzzle&)
  *
  * This function takes in a file path to a .txt file and opens it. Should the
  * file fail to open, the function returns false. 
  *
- * If the file opens successfully, each character is then read in, ignoring
- * white space. Each character is used as a value in a new square, which is
- * added to a global Puzzle variable called 'puzzle'. If the character read
- * in is not a '-' character, the square added is also flaged as a preset
- * value.
+ * If the file opens successfully, the puzzle is read in by readPuzzle, which
+ * sets a square of the puzzle for each character, ignoring white space. A single puzzle run solves exactly one puzzle, so a file holding
+ * anything after the puzzle is rejected as the wrong size.
+ *
+ * The board order is fixed when the program is built, so a puzzle with the
+ * wrong number of squares, or with a symbol that is not a value on this size
+ * of board, is rejected.
  *
  * params:
  *		file_name - the path to the text file containing the puzzle to be
  *					read in
+ *		   puzzle - receives the squares of the puzzle
  *			 
  * returns: true if the file was read in successfully, false if the file failed
- * 			to open
+ * 			to open or does not hold a puzzle of the right size
  *****************************************************************************/
-bool readInPuzzle(char* file_name)
+bool readInPuzzle(char* file_name, Puzzle &puzzle)
 {
 	ifstream file(file_name);
 
@@ -486,28 +424,31 @@ bool readInPuzzle(char* file_name)
 		return false;
 	}
 
+	string error;
+	bool read = readPuzzle(file, puzzle, error);
+
+	// count the squares read, including any beyond the bounds of the puzzle
+	int i = read ? BOARD_SQUARES : 0;
 	char value;
-	int i = 0;
+	while (read && file >> value)
+	{
+		i++;
+	}
+	file.close();
 
-	// read in characters ignoring white space
-	while (file >> value)
+	if (!read && !error.empty())
 	{
-		// insert into puzzle
-		if(value != '-')
-		{
-			initial_puzzle.addSquare(square(value, const_data.DIM, true));
-		}
-		else
-		{
-			initial_puzzle.addSquare(square(value, const_data.DIM));
-		}
-		// increment position, not going beyond bounds of puzzle
-		if (i < (const_data.DIM * const_data.DIM)){
-			i++;
-		}
+		cout << error << "  Exiting program..." << endl;
+		return false;
 	}
 
-	file.close();
+	// the puzzle must fill the board this program was built for
+	if (i != (params.DIM * params.DIM))
+	{
+		cout << "Read " << i << " squares, but this program solves " << params.DIM << "x" << params.DIM;
+		cout << " puzzles (" << (params.DIM * params.DIM) << " squares).  Exiting program..." << endl;
+		return false;
+	}
 	return true;
 }
 
@@ -524,6 +465,17 @@ void printUsage()
 	cout << "Mandatory Parameter: filename" << endl;
 	cout << "Additional Options - Default:\npopulation  - 1000\ngeneration - 1000" << endl;
 	cout << "selection - 0.4\nmutation - 0.05\nelitism - 1" << endl;
+	cout << "Named Options:\n--seed N - random seed (default: current time)" << endl;
+	cout << "--preprocess none|singles|all - logic used before the GA (default: all)" << endl;
+	cout << "--engine ga|exact|anneal - genetic algorithm, exact backtracking search or simulated annealing (default: ga)" << endl;
+	cout << "--local-search N - swaps tried on each child by local search (default: 0, off)" << endl;
+	cout << "--islands N - populations evolved at once, one per thread (default: 1)" << endl;
+	cout << "--migration K - generations between migrations between islands (default: 10)" << endl;
+	cout << "--shm NAME --rank K --ranks N - run as island K of N processes linked by shared memory" << endl;
+	cout << "--listen ADDR --connect ADDR [--rank K] - run as an island process linked by sockets, ADDR is" << endl;
+	cout << "    [host:]port for TCP or a path for a Unix socket" << endl;
+	cout << "--batch N - solve every puzzle in filename, a file of puzzles or a directory of .txt files," << endl;
+	cout << "    on N worker threads (0 = one per core)" << endl;
 	cout << "Sample Usage:\n.\\sudoku puzzle.txt 2000 5000 0.6 0.1 0" << endl;
 	cout << "Exiting program..." << endl;
 
@@ -542,16 +494,59 @@ void printUsage()
 void printStartParams(char* file_name, double selection)
 {
 	cout << left << setw(25)<< "Sudoku: " << file_name << endl;
-	cout << left << setw(25)<< "population size: " << const_data.POP << endl;
-	cout << left << setw(25)<< "number of generations: " << const_data.GENERATIONS << endl;
+	if (params.BATCH >= 0)
+	{
+		cout << left << setw(25)<< "batch threads: ";
+		if (params.BATCH == 0)
+			cout << "one per core" << endl;
+		else
+			cout << params.BATCH << endl;
+	}
+	cout << left << setw(25)<< "population size: " << params.POP << endl;
+	cout << left << setw(25)<< "number of generations: " << params.GENERATIONS << endl;
 	cout << left << setw(25)<< "selection rate: " << selection << endl;
-	cout << left << setw(25)<< "mutation rate: " << const_data.START_MUTATE / 100.0 << endl;
+	cout << left << setw(25)<< "mutation rate: " << params.START_MUTATE / 100.0 << endl;
+	cout << left << setw(25)<< "random seed: " << params.SEED << endl;
+	const char* levels[] = {"none", "singles", "all"};
+	cout << left << setw(25)<< "preprocessing: " << levels[params.PREPROCESS] << endl;
+	const char* engines[] = {"genetic algorithm", "exact search", "simulated annealing"};
+	cout << left << setw(25)<< "engine: " << engines[params.ENGINE] << endl;
+	cout << left << setw(25)<< "islands: ";
+	if (!params.SHM_NAME.empty())
+	{
+		cout << "rank " << params.RANK << " of " << params.RANKS << " over shared memory " << params.SHM_NAME << endl;
+	}
+	else if (!params.LISTEN.empty())
+	{
+		cout << "rank " << params.RANK << ", listening on " << params.LISTEN << ", sending to " << params.CONNECT << endl;
+	}
+	else if (params.ISLANDS > 1)
+	{
+		cout << params.ISLANDS << ", " << ISLAND_MIGRANTS << " migrants every " << params.MIGRATION << " generations" << endl;
+	}
+	else
+	{
+		cout << "OFF" << endl;
+	}
+	cout << left << setw(25)<< "local search: ";
+	if (params.LOCAL_SEARCH > 0)
+	{
+		cout << params.LOCAL_SEARCH << " swaps per child" << endl;
+	}
+	else
+	{
+		cout << "OFF" << endl;
+	}
+	cout << left << setw(25)<< "bytes per individual: " << sizeof(Puzzle) << endl;
+	// population and new generation are both held at once
+	long long individuals = (long long)params.POP * 2;
+	cout << left << setw(25)<< "population memory: " << (individuals * sizeof(Puzzle)) / 1024.0 << " KB" << endl;
 	cout << left << setw(25)<< "elitism: ";
-	if (const_data.ELITISM_FLAG){
+	if (params.ELITISM_FLAG){
 		cout << "ON" << endl;
-		cout << left << setw(25)<< "breeders: " << const_data.BREEDERS << endl;
-		cout << left << setw(25)<< "elite progessers: " << const_data.ELITE << endl;
-		cout << left << setw(25)<< "lucky progressers: " << const_data.LUCKY << endl;
+		cout << left << setw(25)<< "breeders: " << params.BREEDERS << endl;
+		cout << left << setw(25)<< "elite progessers: " << params.ELITE << endl;
+		cout << left << setw(25)<< "lucky progressers: " << params.LUCKY << endl;
 	}
 	else
 	{
@@ -559,7 +554,7 @@ void printStartParams(char* file_name, double selection)
 	}
 
 	cout << left << setw(25)<< "mutation only: ";
-	if (const_data.MUTATE_ONLY_FLAG){
+	if (params.MUTATE_ONLY_FLAG){
 		cout << "ON" << endl;
 	}
 	else
@@ -569,41 +564,3 @@ void printStartParams(char* file_name, double selection)
 
 	cout << endl;
 }
-
-/******************************************************************************
- * evaluatePresetCounts()
- *
- * This function counts the number of preset values in each subgrid of the
- * initial puzzle after singles have been filled. This values is then saved
- * into a vector in the puzzle class. This is to avoid having to repeat this
- * preset count for every subgrid we want to mutate later.
- *****************************************************************************/
-void evaluatePresetCounts()
-{
-	vector<square> grid;
-	vector<int> subgrid_presets;
-	int count;
-	int r;
-	int c;
-	
-	// go through each subgrid in the puzzle
-	for (int i = 0; i < const_data.DIM; i++)
-	{
-		count = 0;
-		// get row and column for subgrid position
-		r = (i / const_data.SUBDIM) * const_data.SUBDIM;
-		c = (i % const_data.SUBDIM) * const_data.SUBDIM;
-
-		grid = initial_puzzle.getSub(r, c);
-
-		// count up the number of preset values in the subgrid
-		for (int j = 0; j < grid.size(); j++)
-		{
-			if (grid[i].preset)
-				count++;
-		}
-		subgrid_presets.push_back(count);
-	}
-	// store preset vector in the initial puzzle
-	initial_puzzle.subgrid_presets = subgrid_presets;
-}
\ No newline at end of file